@@ -0,0 +1,149 @@
+#pragma once
+
+// A small runner for the benchmarks in this directory. Each case is timed in batches calibrated to a minimum
+// duration and reported as the median over several batches, as a table and optionally as JSON so runs of
+// different versions can be compared by script.
+//
+// Command line: --json[=file]   also write the results as JSON; to stdout when no file is given, in which
+//                               case the table goes to stderr
+//               --filter=text   run only the cases whose name contains text
+//               --min-time=ms   minimum duration of a timed batch, default 20
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "other/Instrument.hpp"
+
+template <class T>
+inline void DoNotOptimize(const T& x) {
+    asm volatile("" : : "r,m"(x) : "memory");
+}
+
+class BenchRunner {
+public:
+    BenchRunner(int argc, char** argv) {
+        // Assigned from std::string temporaries: GCC 12 falsely reports -Wrestrict on operator=(const char*) here
+        for(int i = 1; i < argc; i++) {
+            if(std::strcmp(argv[i], "--json") == 0)
+                JsonPath = std::string("-");
+            else if(std::strncmp(argv[i], "--json=", 7) == 0)
+                JsonPath = std::string(argv[i] + 7);
+            else if(std::strncmp(argv[i], "--filter=", 9) == 0)
+                Filter = std::string(argv[i] + 9);
+            else if(std::strncmp(argv[i], "--min-time=", 11) == 0)
+                MinTime = std::chrono::duration<double, std::milli>(std::atof(argv[i] + 11));
+            else {
+                std::fprintf(stderr, "usage: %s [--json[=file]] [--filter=text] [--min-time=ms]\n", argv[0]);
+                std::exit(2);
+            }
+        }
+
+        // Keep stdout clean for the JSON when it goes there
+        Table = JsonPath == "-" ? stderr : stdout;
+        std::fprintf(Table, "%-40s %-12s %8s %14s %14s\n", "benchmark", "type", "size", "ns/op", "ns/item");
+    }
+
+    BenchRunner(const BenchRunner&) = delete;
+    BenchRunner& operator=(const BenchRunner&) = delete;
+
+    ~BenchRunner() {
+        if(!JsonPath.empty())
+            __write_json();
+    }
+
+    /**
+     * @brief Times op(), which performs one operation on a problem of the given size touching items elements.
+     * @note With instrumentation compiled in, one extra call of op() is made to record its counters.
+     */
+    template <class F>
+    void Run(const std::string& name, const std::string& type, size_t size, size_t items, F&& op) {
+        if(!Filter.empty() && name.find(Filter) == std::string::npos)
+            return;
+
+        using clock = std::chrono::steady_clock;
+        auto time_batch = [&](size_t reps) {
+            const auto start = clock::now();
+            for(size_t r = 0; r < reps; r++)
+                op();
+            return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        };
+
+        // Grow the batch until it lasts MinTime, then keep the median of a few batches of that size
+        size_t reps = 1;
+        for(double t = time_batch(reps); t < std::chrono::duration<double, std::nano>(MinTime).count() && reps < (size_t(1) << 40); t = time_batch(reps))
+            reps *= 2;
+
+        std::vector<double> samples(5);
+        for(auto& s : samples)
+            s = time_batch(reps) / double(reps);
+        std::sort(samples.begin(), samples.end());
+
+        __result res { name, type, size, items, reps, samples[samples.size() / 2], samples.front(), {} };
+        if constexpr(Instrument::Enabled) {
+            Instrument::Reset();
+            op();
+            for(const auto& s : Instrument::Snapshot())
+                if(s.Calls > 0)
+                    res.Counters.push_back(s);
+        }
+
+        std::fprintf(Table, "%-40s %-12s %8zu %14.2f %14.3f\n", name.c_str(), type.c_str(), size, res.NsPerOp, res.NsPerOp / double(items));
+        std::fflush(Table);
+        Results.push_back(std::move(res));
+    }
+
+    template <class F>
+    void Run(const std::string& name, const std::string& type, size_t size, F&& op) {
+        Run(name, type, size, 1, std::forward<F>(op));
+    }
+
+private:
+    struct __result {
+        std::string Name;
+        std::string Type;
+        size_t Size;
+        size_t Items;
+        size_t Repetitions;
+        double NsPerOp;
+        double MinNsPerOp;
+        std::vector<Instrument::OpStats> Counters;
+    };
+
+    void __write_json() const {
+        std::FILE* out = JsonPath == "-" ? stdout : std::fopen(JsonPath.c_str(), "w");
+        if(out == nullptr) {
+            std::fprintf(stderr, "cannot open %s\n", JsonPath.c_str());
+            return;
+        }
+
+        std::fprintf(out, "{\"context\": {\"compiler\": \"%s\", \"instrumented\": %s}, \"benchmarks\": [", __VERSION__, Instrument::Enabled ? "true" : "false");
+        for(size_t i = 0; i < Results.size(); i++) {
+            const auto& r = Results[i];
+            std::fprintf(out, "%s\n  {\"name\": \"%s\", \"type\": \"%s\", \"size\": %zu, \"items\": %zu, \"repetitions\": %zu, "
+                              "\"ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, \"ns_per_item\": %.4f",
+                         i > 0 ? "," : "", r.Name.c_str(), r.Type.c_str(), r.Size, r.Items, r.Repetitions,
+                         r.NsPerOp, r.MinNsPerOp, r.NsPerOp / double(r.Items));
+            if(Instrument::Enabled) {
+                std::fprintf(out, ", \"counters\": ");
+                Instrument::WriteJson(out, r.Counters);
+            }
+            std::fprintf(out, "}");
+        }
+        std::fprintf(out, "\n]}\n");
+
+        if(out != stdout)
+            std::fclose(out);
+    }
+
+    std::string JsonPath;
+    std::string Filter;
+    std::chrono::duration<double, std::milli> MinTime { 20.0 };
+    std::FILE* Table = stdout;
+    std::vector<__result> Results;
+};
@@ -0,0 +1,191 @@
+// Timings of the core numeric operations across sizes and types, for tracking performance between versions.
+// Build with the CMake project (target bench_numeric), or from the repository root:
+//     g++ -std=c++20 -O2 -I. bench/numeric.cpp -o numeric_bench
+// Run with --json=results.json to keep the numbers; see bench/Harness.hpp for the other options.
+
+// When built with MATHPHY_INSTRUMENT=1, this is the translation unit that counts allocations
+#define MATHPHY_INSTRUMENT_DEFINE_NEW
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/Harness.hpp"
+#include "numeric/DoubleDouble.hpp"
+#include "numeric/Elementary.hpp"
+#include "numeric/Interpolators.hpp"
+#include "numeric/Matrices.hpp"
+#include "numeric/Polynomial.hpp"
+#include "numeric/uint128_t.hpp"
+
+static std::mt19937_64 rng(12345);
+
+template <class T>
+T uniform(double lo, double hi) {
+    return T(std::uniform_real_distribution<double>(lo, hi)(rng));
+}
+
+template <class T>
+Polynomial<T> random_polynomial(size_t degree) {
+    Polynomial<T> p;
+    p.Coefficients.resize(degree + 1);
+    for(auto& c : p.Coefficients)
+        c = uniform<T>(0.5, 1.5);
+    return p;
+}
+
+template <class T>
+void bench_polynomial(BenchRunner& runner, const char* type) {
+    for(size_t degree : { 8, 64, 512 }) {
+        const auto a = random_polynomial<T>(degree), b = random_polynomial<T>(degree);
+        const auto c = a * b;
+
+        // The in-place kernels are timed with the copy of their left operand, as operator* and operator/ do
+        runner.Run("__polynomial_mul", type, degree, [&] {
+            auto res = a;
+            __polynomial_mul(res, b);
+            DoNotOptimize(res.Coefficients.data());
+        });
+        runner.Run("__polynomial_div", type, degree, [&] {
+            auto res = __polynomial_div(c, b);
+            DoNotOptimize(res.first.Coefficients.data());
+        });
+
+        T x = uniform<T>(-1.0, 1.0);
+        runner.Run("Polynomial::operator()", type, degree, [&] {
+            DoNotOptimize(x);
+            DoNotOptimize(a(x));
+        });
+    }
+
+    constexpr size_t points = 1 << 16;
+    std::vector<T> xs(points), ys(points);
+    for(auto& x : xs)
+        x = uniform<T>(-1.0, 1.0);
+
+    for(size_t degree : { 8, 64 }) {
+        const auto p = random_polynomial<T>(degree);
+        runner.Run("Polynomial::EvaluateBatch", type, degree, points, [&] {
+            p.EvaluateBatch(xs, ys);
+            DoNotOptimize(ys.data());
+        });
+    }
+}
+
+void bench_barycentric(BenchRunner& runner) {
+    for(size_t n : { 16, 64, 256 }) {
+        const auto nodes = Interpolator::CreateChebyshevNodes([](double x) { return std::exp(x) * std::sin(5 * x); }, -1.0, 1.0, n);
+
+        // Weights are computed on the first evaluation, so building includes one
+        runner.Run("CreateBarycentricInterpolator build", "double", n, [&] {
+            auto f = Interpolator::Lagrange::CreateBarycentricInterpolator(nodes);
+            DoNotOptimize(f(0.25));
+        });
+
+        auto f = Interpolator::Lagrange::CreateBarycentricInterpolator(nodes);
+        double x = 0.25;
+        runner.Run("CreateBarycentricInterpolator evaluate", "double", n, [&] {
+            DoNotOptimize(x);
+            DoNotOptimize(f(x));
+        });
+    }
+}
+
+template <class T, size_t N>
+void bench_matrix(BenchRunner& runner, const char* type) {
+    auto A = std::make_unique<Matrix<T, N, N>>(), B = std::make_unique<Matrix<T, N, N>>();
+    for(size_t i = 0; i < N; i++)
+        for(size_t j = 0; j < N; j++)
+            (*A)[i][j] = uniform<T>(-1.0, 1.0) + T(i == j ? 4.0 : 0.0), (*B)[i][j] = uniform<T>(-1.0, 1.0);
+
+    auto C = std::make_unique<Matrix<T, N, N>>();
+    runner.Run("MatrixMul", type, N, [&] {
+        *C = MatrixMul(*A, *B);
+        DoNotOptimize(C.get());
+    });
+    runner.Run("Det", type, N, [&] {
+        DoNotOptimize(A.get());
+        DoNotOptimize(Det(*A));
+    });
+}
+
+void bench_uint128(BenchRunner& runner) {
+    constexpr size_t n = 1024;
+    struct Case { const char* type; int divisor_bits; };
+
+    for(auto [type, bits] : { Case{ "64-bit div", 64 }, Case{ "128-bit div", 128 } }) {
+        std::vector<uint128_t> a(n), b(n);
+        for(size_t i = 0; i < n; i++) {
+            a[i] = uint128_t(rng(), rng());
+            b[i] = bits == 64 ? uint128_t(rng() | 1) : uint128_t(rng() >> (i % 48) | 1, rng());
+        }
+
+        auto run = [&](const char* name, auto op) {
+            runner.Run(name, type, n, n, [&] {
+                uint128_t acc = 0;
+                for(size_t i = 0; i < n; i++)
+                    acc += op(a[i], b[i]);
+                DoNotOptimize(acc);
+            });
+        };
+
+        run("uint128_t operator+", [](uint128_t x, uint128_t y) { return x + y; });
+        run("uint128_t operator-", [](uint128_t x, uint128_t y) { return x - y; });
+        run("uint128_t operator*", [](uint128_t x, uint128_t y) { return x * y; });
+        run("uint128_t operator/", [](uint128_t x, uint128_t y) { return x / y; });
+        run("uint128_t operator%", [](uint128_t x, uint128_t y) { return x % y; });
+        run("uint128_t operator<<=", [](uint128_t x, uint128_t y) { return x <<= y.Lo() % 128; });
+    }
+}
+
+template <class T>
+void bench_sqrt(BenchRunner& runner, const char* type) {
+    constexpr size_t n = 1024;
+    std::vector<T> x(n);
+    for(auto& v : x)
+        v = uniform<T>(0.0, 1e6);
+
+    runner.Run("Sqrt", type, n, n, [&] {
+        T acc = 0;
+        for(size_t i = 0; i < n; i++)
+            acc += Sqrt(x[i]);
+        DoNotOptimize(acc);
+    });
+}
+
+void bench_sqrt_span(BenchRunner& runner) {
+    for(size_t n : { 1 << 10, 1 << 16 }) {
+        std::vector<double> x(n), y(n);
+        for(auto& v : x)
+            v = uniform<double>(0.0, 1e6);
+
+        runner.Run("Sqrt(span)", "double", n, n, [&] {
+            Sqrt(x, y);
+            DoNotOptimize(y.data());
+        });
+    }
+}
+
+int main(int argc, char** argv) {
+    BenchRunner runner(argc, argv);
+
+    bench_polynomial<float>(runner, "float");
+    bench_polynomial<double>(runner, "double");
+    bench_polynomial<DoubleDouble>(runner, "DoubleDouble");
+    bench_barycentric(runner);
+
+    bench_matrix<float, 4>(runner, "float");
+    bench_matrix<float, 16>(runner, "float");
+    bench_matrix<float, 64>(runner, "float");
+    bench_matrix<double, 4>(runner, "double");
+    bench_matrix<double, 16>(runner, "double");
+    bench_matrix<double, 64>(runner, "double");
+    bench_matrix<double, 128>(runner, "double");
+
+    bench_uint128(runner);
+
+    bench_sqrt<float>(runner, "float");
+    bench_sqrt<double>(runner, "double");
+    bench_sqrt_span(runner);
+}
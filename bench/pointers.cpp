@@ -0,0 +1,100 @@
+// SharedPtr, WeakPtr and IntrusivePtr against std::shared_ptr: creation, copies on one thread, and copies
+// of one pointer from several threads at once, where the count's cache line moves between cores.
+// Build from the repository root: g++ -std=c++20 -O2 -I. bench/pointers.cpp -o pointers_bench -pthread
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "other/Pointers.hpp"
+
+constexpr size_t reps = 1 << 20;
+
+struct Payload {
+    double Values[4] = {};
+};
+
+struct CountedPayload : RefCounted<CountedPayload> {
+    double Values[4] = {};
+};
+
+template <class F>
+double ns_per_op(F&& f) {
+    f();
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / double(reps);
+}
+
+template <class T>
+void do_not_optimize(const T& x) {
+    asm volatile("" : : "r,m"(x) : "memory");
+}
+
+// Make and drop reps objects
+template <class Make>
+double create(Make&& make) {
+    return ns_per_op([&] {
+        for(size_t i = 0; i < reps; i++) {
+            auto p = make();
+            do_not_optimize(p);
+        }
+    });
+}
+
+// Copy and drop one pointer reps times on each of the given number of threads
+template <class Ptr>
+double copy(const Ptr& p, unsigned threads) {
+    return ns_per_op([&] {
+        std::vector<std::jthread> pool;
+        for(unsigned t = 0; t < threads; t++)
+            pool.emplace_back([&] {
+                for(size_t i = 0; i < reps; i++) {
+                    Ptr q = p;
+                    do_not_optimize(q);
+                }
+            });
+    });
+}
+
+int main() {
+    // libstdc++ skips its atomics until the process starts a second thread; start one so that every row
+    // measures the multi-threaded regime these pointers are for
+    std::jthread([] {}).join();
+
+    const unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    auto row = [](const char* name, double ns) { std::printf("  %-32s %7.2f ns/op\n", name, ns); };
+
+    std::printf("create + destroy\n");
+    row("std::make_shared", create([] { return std::make_shared<Payload>(); }));
+    row("std::shared_ptr(new T)", create([] { return std::shared_ptr<Payload>(new Payload()); }));
+    row("MakeShared", create([] { return MakeShared<Payload>(); }));
+    row("MakeShared<NonAtomicRefCount>", create([] { return MakeShared<Payload, NonAtomicRefCount>(); }));
+    row("SharedPtr(new T)", create([] { return SharedPtr<Payload>(new Payload()); }));
+    row("MakeIntrusive", create([] { return MakeIntrusive<CountedPayload>(); }));
+
+    std::printf("copy + destroy, 1 thread\n");
+    const auto std_p = std::make_shared<Payload>();
+    const auto p = MakeShared<Payload>();
+    const auto local_p = MakeShared<Payload, NonAtomicRefCount>();
+    const auto ip = MakeIntrusive<CountedPayload>();
+    row("std::shared_ptr", copy(std_p, 1));
+    row("SharedPtr", copy(p, 1));
+    row("SharedPtr<NonAtomicRefCount>", copy(local_p, 1));
+    row("IntrusivePtr", copy(ip, 1));
+
+    std::printf("weak lock + destroy, 1 thread\n");
+    const std::weak_ptr<Payload> std_w = std_p;
+    const WeakPtr<Payload> w = p;
+    row("std::weak_ptr::lock", ns_per_op([&] { for(size_t i = 0; i < reps; i++) { auto q = std_w.lock(); do_not_optimize(q); } }));
+    row("WeakPtr::Lock", ns_per_op([&] { for(size_t i = 0; i < reps; i++) { auto q = w.Lock(); do_not_optimize(q); } }));
+
+    std::printf("copy + destroy, %u threads sharing one pointer\n", threads);
+    row("std::shared_ptr", copy(std_p, threads) / threads);
+    row("SharedPtr", copy(p, threads) / threads);
+    row("IntrusivePtr", copy(ip, threads) / threads);
+}
@@ -0,0 +1,75 @@
+// Throughput of the array-level uint128_t kernels against loops over the scalar operators.
+// Build from the repository root: g++ -std=c++20 -O2 -march=native -I. bench/uint128_batch.cpp -o uint128_batch_bench
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "numeric/uint128_batch.hpp"
+
+// Arrays stay cache-resident and every pass is repeated, so the timings show compute rather than page faults
+constexpr size_t reps = 2000;
+
+template <class F>
+double ns_per_op(size_t n, F&& f) {
+    f();
+    auto start = std::chrono::steady_clock::now();
+    for(size_t r = 0; r < reps; r++)
+        f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / double(n * reps);
+}
+
+template <class T>
+void do_not_optimize(const T& x) {
+    asm volatile("" : : "r,m"(x) : "memory");
+}
+
+int main() {
+    constexpr size_t n = 1 << 12;
+    std::mt19937_64 rng(12345);
+
+    std::vector<uint128_t> a(n), b(n), out(n);
+    std::vector<uint64_t> m(n);
+    std::vector<int8_t> cmp(n);
+    for(size_t i = 0; i < n; i++) {
+        a[i] = uint128_t(rng(), rng());
+        b[i] = uint128_t(rng(), rng());
+        m[i] = rng();
+    }
+
+    uint128_t acc = 0;
+    auto row = [](const char* name, double scalar, double batch) {
+        std::printf("  %-10s scalar %6.2f ns/elem   batch %6.2f ns/elem   x%.2f\n", name, scalar, batch, scalar / batch);
+    };
+
+#if defined(__AVX512F__)
+    std::printf("[AVX-512]\n");
+#elif defined(__AVX2__)
+    std::printf("[AVX2]\n");
+#else
+    std::printf("[scalar only; build with -march=native for the vector paths]\n");
+#endif
+
+    row("add",
+        ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) out[i] = a[i] + b[i]; do_not_optimize(out[n - 1]); }),
+        ns_per_op(n, [&] { Batch::Add(a, b, out); do_not_optimize(out[n - 1]); }));
+    row("sub",
+        ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) out[i] = a[i] - b[i]; do_not_optimize(out[n - 1]); }),
+        ns_per_op(n, [&] { Batch::Sub(a, b, out); do_not_optimize(out[n - 1]); }));
+    row("mul64",
+        ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) out[i] = a[i] * uint128_t(m[i]); do_not_optimize(out[n - 1]); }),
+        ns_per_op(n, [&] { Batch::Mul(a, m, out); do_not_optimize(out[n - 1]); }));
+    row("compare",
+        ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) cmp[i] = int8_t(a[i] < b[i] ? -1 : (b[i] < a[i] ? 1 : 0)); do_not_optimize(cmp[n - 1]); }),
+        ns_per_op(n, [&] { Batch::Compare(a, b, cmp); do_not_optimize(cmp[n - 1]); }));
+    row("sum",
+        ns_per_op(n, [&] { uint128_t s = 0; for(size_t i = 0; i < n; i++) s += a[i]; acc += s; }),
+        ns_per_op(n, [&] { acc += Batch::Sum(a); }));
+    row("prefix",
+        ns_per_op(n, [&] { uint128_t s = 0; for(size_t i = 0; i < n; i++) out[i] = s += a[i]; do_not_optimize(out[n - 1]); }),
+        ns_per_op(n, [&] { Batch::PrefixSum(a, out); do_not_optimize(out[n - 1]); }));
+
+    do_not_optimize(acc);
+}
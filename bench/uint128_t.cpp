@@ -0,0 +1,60 @@
+// Throughput of uint128_t arithmetic against the compiler's unsigned __int128.
+// Build from the repository root: g++ -std=c++20 -O2 -I. bench/uint128_t.cpp -o uint128_bench
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "numeric/uint128_t.hpp"
+
+#if !__UINT128_HAS_NATIVE
+#error "This benchmark compares against unsigned __int128, which this compiler does not provide."
+#endif
+
+using native_t = unsigned __int128;
+
+template <class F>
+double ns_per_op(size_t n, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / double(n);
+}
+
+template <class T>
+void do_not_optimize(const T& x) {
+    asm volatile("" : : "r,m"(x) : "memory");
+}
+
+int main() {
+    constexpr size_t n = 1 << 20;
+    std::mt19937_64 rng(12345);
+
+    struct Case { const char* name; int divisor_bits; };
+    for(auto [name, bits] : { Case{ "64-bit divisor", 64 }, Case{ "128-bit divisor", 128 } }) {
+        std::vector<uint128_t> a(n), b(n);
+        std::vector<native_t> na(n), nb(n);
+        for(size_t i = 0; i < n; i++) {
+            a[i] = uint128_t(rng(), rng());
+            b[i] = bits == 64 ? uint128_t(rng() | 1) : uint128_t(rng() >> (i % 48) | 1, rng());
+            na[i] = native_t(a[i]), nb[i] = native_t(b[i]);
+        }
+
+        uint128_t acc = 0, rem;
+        native_t nacc = 0;
+
+        std::printf("[%s]\n", name);
+        std::printf("  uint128_t /         %7.2f ns/op\n", ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) acc += a[i] / b[i]; }));
+        std::printf("  portable /          %7.2f ns/op\n", ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) acc += __udiv128_portable(a[i], b[i], rem); }));
+        std::printf("  unsigned __int128 / %7.2f ns/op\n", ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) nacc += na[i] / nb[i]; }));
+        std::printf("  uint128_t %%         %7.2f ns/op\n", ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) acc += a[i] % b[i]; }));
+        std::printf("  unsigned __int128 %% %7.2f ns/op\n", ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) nacc += na[i] % nb[i]; }));
+        std::printf("  uint128_t *         %7.2f ns/op\n", ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) acc += a[i] * b[i]; }));
+        std::printf("  unsigned __int128 * %7.2f ns/op\n", ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) nacc += na[i] * nb[i]; }));
+        std::printf("  __umul128           %7.2f ns/op\n", ns_per_op(n, [&] { for(size_t i = 0; i < n; i++) acc += __umul128(a[i].Lo(), b[i].Lo()); }));
+
+        do_not_optimize(acc);
+        do_not_optimize(nacc);
+    }
+}
@@ -0,0 +1,737 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "uint128_t.hpp"
+
+// ############################################### LIMB STORAGE #########################################
+
+/// @brief Little-endian 64-bit limbs with a few limbs stored inline before falling back to the heap.
+class __limb_storage {
+public:
+    static constexpr size_t InlineLimbs = 4;
+
+    __limb_storage() noexcept = default;
+    __limb_storage(const __limb_storage& other) { assign(other.data(), other._Size); }
+    __limb_storage(__limb_storage&& other) noexcept { *this = std::move(other); }
+
+    __limb_storage& operator=(const __limb_storage& other) {
+        if(this != &other)
+            assign(other.data(), other._Size);
+        return *this;
+    }
+
+    __limb_storage& operator=(__limb_storage&& other) noexcept {
+        if(this == &other)
+            return *this;
+
+        if(other._Heap) {
+            _Heap = std::move(other._Heap);
+            _Capacity = other._Capacity;
+        }
+        else {
+            _Heap.reset();
+            _Capacity = InlineLimbs;
+            std::copy_n(other._Inline, other._Size, _Inline);
+        }
+        _Size = std::exchange(other._Size, 0);
+        other._Capacity = InlineLimbs;
+        return *this;
+    }
+
+    size_t size() const noexcept { return _Size; }
+    uint64_t* data() noexcept { return _Heap ? _Heap.get() : _Inline; }
+    const uint64_t* data() const noexcept { return _Heap ? _Heap.get() : _Inline; }
+
+    uint64_t& operator[](size_t i) noexcept { return data()[i]; }
+    const uint64_t& operator[](size_t i) const noexcept { return data()[i]; }
+
+    void reserve(size_t n) {
+        if(n <= _Capacity)
+            return;
+
+        std::unique_ptr<uint64_t[]> p(new uint64_t[n]);
+        std::copy_n(data(), _Size, p.get());
+        _Heap = std::move(p);
+        _Capacity = n;
+    }
+
+    /// @brief Resize to `n` limbs, zero-filling any new ones.
+    void resize(size_t n) {
+        if(n > _Capacity)
+            reserve(std::max(n, 2 * _Capacity));
+        if(n > _Size)
+            std::fill(data() + _Size, data() + n, uint64_t(0));
+        _Size = n;
+    }
+
+    void assign(const uint64_t* p, size_t n) {
+        _Size = 0;
+        reserve(n);
+        std::copy_n(p, n, data());
+        _Size = n;
+    }
+
+private:
+    uint64_t _Inline[InlineLimbs] = {};
+    std::unique_ptr<uint64_t[]> _Heap;
+    size_t _Size = 0, _Capacity = InlineLimbs;
+};
+
+// ############################################### LIMB KERNELS #########################################
+// All kernels take little-endian limb arrays. Unless stated otherwise, an output may alias an input
+// only when both start at the same limb.
+
+// r = a + b for an >= bn, returning the carry out of limb an - 1
+inline uint64_t __limbs_add(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) noexcept {
+    uint64_t carry = 0;
+    for(size_t i = 0; i < bn; i++) {
+        uint64_t s = a[i] + carry;
+        uint64_t c = s < carry;
+        s += b[i];
+        c += s < b[i];
+        r[i] = s, carry = c;
+    }
+    for(size_t i = bn; i < an; i++) {
+        const uint64_t s = a[i] + carry;
+        carry = s < carry;
+        r[i] = s;
+    }
+    return carry;
+}
+
+// r = a - b for an >= bn, returning the borrow out of limb an - 1
+inline uint64_t __limbs_sub(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) noexcept {
+    uint64_t borrow = 0;
+    for(size_t i = 0; i < bn; i++) {
+        const uint64_t ai = a[i], bi = b[i] + borrow;
+        borrow = (bi < borrow) | (ai < bi);
+        r[i] = ai - bi;
+    }
+    for(size_t i = bn; i < an; i++) {
+        const uint64_t ai = a[i];
+        r[i] = ai - borrow;
+        borrow = ai < borrow;
+    }
+    return borrow;
+}
+
+// r[0, n) += a[0, n) * m, returning the carry limb
+inline uint64_t __limbs_addmul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t m) noexcept {
+    uint64_t carry = 0;
+    for(size_t i = 0; i < n; i++) {
+        uint128_t p = __umul128(a[i], m);
+        p += uint128_t(carry);
+        p += uint128_t(r[i]);
+        r[i] = p.Lo(), carry = p.Hi();
+    }
+    return carry;
+}
+
+// r[0, n) -= a[0, n) * m, returning the borrow limb
+inline uint64_t __limbs_submul_1(uint64_t* r, const uint64_t* a, size_t n, uint64_t m) noexcept {
+    uint64_t carry = 0;
+    for(size_t i = 0; i < n; i++) {
+        uint128_t p = __umul128(a[i], m);
+        p += uint128_t(carry);
+        const uint64_t t = r[i];
+        r[i] = t - p.Lo();
+        carry = p.Hi() + (t < p.Lo());
+    }
+    return carry;
+}
+
+// q = a / d over n limbs (q may alias a), returning the remainder
+inline uint64_t __limbs_divmod_1(uint64_t* q, const uint64_t* a, size_t n, uint64_t d) noexcept {
+    uint64_t rem = 0;
+    for(size_t i = n; i-- > 0;)
+        q[i] = __udiv128by64(rem, a[i], d, rem);
+    return rem;
+}
+
+// r[0, an + bn) = a * b; r must not alias a or b
+inline void __limbs_mul_basecase(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) noexcept {
+    std::fill(r, r + an + bn, uint64_t(0));
+    for(size_t j = 0; j < bn; j++)
+        r[an + j] = __limbs_addmul_1(r + j, a, an, b[j]);
+}
+
+inline void __limbs_mul(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn);
+
+// Karatsuba for an >= bn > (an + 1) / 2
+inline void __limbs_mul_karatsuba(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    const size_t h = (an + 1) / 2;
+    const size_t a1n = an - h, b1n = bn - h;
+
+    // z0 = a0 * b0 in r[0, 2h), z2 = a1 * b1 in r[2h, an + bn)
+    __limbs_mul(r, a, h, b, h);
+    __limbs_mul(r + 2 * h, a + h, a1n, b + h, b1n);
+
+    std::vector<uint64_t> sa(h + 1), sb(h + 1), z1(2 * h + 2);
+    sa[h] = __limbs_add(sa.data(), a, h, a + h, a1n);
+    sb[h] = __limbs_add(sb.data(), b, h, b + h, b1n);
+    __limbs_mul(z1.data(), sa.data(), h + 1, sb.data(), h + 1);
+
+    // z1 = (a0 + a1)(b0 + b1) - z0 - z2, then r += z1 * B^h
+    __limbs_sub(z1.data(), z1.data(), z1.size(), r, 2 * h);
+    __limbs_sub(z1.data(), z1.data(), z1.size(), r + 2 * h, a1n + b1n);
+
+    size_t zn = z1.size();
+    while(zn > 0 && z1[zn - 1] == 0) zn--;
+    __limbs_add(r + h, r + h, an + bn - h, z1.data(), zn);
+}
+
+// r[0, an + bn) = a * b; r must not alias a or b
+inline void __limbs_mul(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    constexpr size_t KaratsubaThreshold = 32;
+
+    if(an < bn)
+        std::swap(a, b), std::swap(an, bn);
+    if(bn == 0) {
+        std::fill(r, r + an, uint64_t(0));
+        return;
+    }
+    if(bn < KaratsubaThreshold) {
+        __limbs_mul_basecase(r, a, an, b, bn);
+        return;
+    }
+    if(2 * bn <= an) {
+        // Unbalanced: multiply b by bn-limb slices of a
+        std::fill(r, r + an + bn, uint64_t(0));
+        std::vector<uint64_t> tmp(2 * bn);
+        for(size_t off = 0; off < an; off += bn) {
+            const size_t len = std::min(bn, an - off);
+            __limbs_mul(tmp.data(), a + off, len, b, bn);
+            __limbs_add(r + off, r + off, an + bn - off, tmp.data(), len + bn);
+        }
+        return;
+    }
+    __limbs_mul_karatsuba(r, a, an, b, bn);
+}
+
+// ############################################### BigUInt #########################################
+
+class BigUInt;
+std::pair<BigUInt, BigUInt> DivMod(const BigUInt& a, const BigUInt& b);
+
+/**
+ * @brief An arbitrary-precision unsigned integer over 64-bit limbs with small-buffer storage.
+ * @note Multiplication moves from schoolbook to Karatsuba to Toom-3 as the operands grow, division uses
+ * Knuth's algorithm D or a Newton reciprocal, and decimal conversion is divide-and-conquer.
+ * Subtracting a larger value throws `std::logic_error`.
+ */
+class BigUInt {
+public:
+    static constexpr size_t Toom3Threshold = 160;   // limbs of the smaller operand
+    static constexpr size_t NewtonThreshold = 48;   // limbs of the divisor
+
+    BigUInt() noexcept = default;
+    BigUInt(uint64_t x) {
+        if(x != 0) _Limbs.resize(1), _Limbs[0] = x;
+    }
+    BigUInt(uint128_t x) {
+        _Limbs.resize(2), _Limbs[0] = x.Lo(), _Limbs[1] = x.Hi();
+        _normalize();
+    }
+    explicit BigUInt(std::string_view decimal);
+
+    static BigUInt FromLimbs(const uint64_t* limbs, size_t n) {
+        BigUInt res;
+        res._Limbs.assign(limbs, n);
+        res._normalize();
+        return res;
+    }
+
+    size_t Size() const noexcept { return _Limbs.size(); }
+    uint64_t Limb(size_t i) const noexcept { return i < _Limbs.size() ? _Limbs[i] : 0; }
+    const uint64_t* Data() const noexcept { return _Limbs.data(); }
+    bool IsZero() const noexcept { return _Limbs.size() == 0; }
+
+    size_t BitLength() const noexcept {
+        return IsZero() ? 0 : 64 * Size() - std::countl_zero(_Limbs[Size() - 1]);
+    }
+
+    explicit operator uint64_t() const noexcept { return Limb(0); }
+
+    std::string ToString() const;
+
+    // ############################ ARITHMETIC ############################
+
+    BigUInt& operator+=(const BigUInt& b) {
+        // b may be *this, so its length is taken before the resize grows it
+        const size_t n = std::max(Size(), b.Size()), bn = b.Size();
+        _Limbs.resize(n + 1);
+        _Limbs[n] = __limbs_add(_Limbs.data(), _Limbs.data(), n, b.Data(), bn);
+        _normalize();
+        return *this;
+    }
+
+    BigUInt& operator-=(const BigUInt& b) {
+        if(*this < b)
+            throw std::logic_error("Attempted to subtract a larger BigUInt from a smaller one");
+        __limbs_sub(_Limbs.data(), _Limbs.data(), Size(), b.Data(), b.Size());
+        _normalize();
+        return *this;
+    }
+
+    BigUInt& operator*=(uint64_t m) {
+        if(m == 0 || IsZero()) {
+            _Limbs.resize(0);
+            return *this;
+        }
+        const size_t n = Size();
+        _Limbs.resize(n + 1);
+        uint64_t carry = 0;
+        for(size_t i = 0; i < n; i++) {
+            uint128_t p = __umul128(_Limbs[i], m);
+            p += uint128_t(carry);
+            _Limbs[i] = p.Lo(), carry = p.Hi();
+        }
+        _Limbs[n] = carry;
+        _normalize();
+        return *this;
+    }
+
+    BigUInt& operator*=(const BigUInt& b) { return *this = *this * b; }
+
+    /// @brief Divide in place by a single limb, returning the remainder.
+    uint64_t DivMod1(uint64_t d) {
+        if(d == 0)
+            throw std::logic_error("Attempted to divide by zero");
+        const uint64_t rem = __limbs_divmod_1(_Limbs.data(), _Limbs.data(), Size(), d);
+        _normalize();
+        return rem;
+    }
+
+    BigUInt& operator/=(const BigUInt& b) { return *this = DivMod(*this, b).first; }
+    BigUInt& operator%=(const BigUInt& b) { return *this = DivMod(*this, b).second; }
+
+    BigUInt& operator<<=(size_t n) {
+        if(IsZero() || n == 0)
+            return *this;
+
+        const size_t limbs = n / 64, bits = n % 64, old = Size();
+        _Limbs.resize(old + limbs + 1);
+        uint64_t* p = _Limbs.data();
+        for(size_t i = old + limbs + 1; i-- > 0;) {
+            const uint64_t hi = (i >= limbs && i - limbs < old) ? p[i - limbs] : 0;
+            const uint64_t lo = (i >= limbs + 1 && i - limbs - 1 < old) ? p[i - limbs - 1] : 0;
+            p[i] = bits == 0 ? hi : (hi << bits) | (lo >> (64 - bits));
+        }
+        _normalize();
+        return *this;
+    }
+
+    BigUInt& operator>>=(size_t n) {
+        const size_t limbs = n / 64, bits = n % 64;
+        if(limbs >= Size()) {
+            _Limbs.resize(0);
+            return *this;
+        }
+
+        uint64_t* p = _Limbs.data();
+        const size_t m = Size() - limbs;
+        for(size_t i = 0; i < m; i++) {
+            const uint64_t lo = p[i + limbs];
+            const uint64_t hi = i + limbs + 1 < Size() ? p[i + limbs + 1] : 0;
+            p[i] = bits == 0 ? lo : (lo >> bits) | (hi << (64 - bits));
+        }
+        _Limbs.resize(m);
+        _normalize();
+        return *this;
+    }
+
+    friend BigUInt operator+(const BigUInt& a, const BigUInt& b) { BigUInt res = a; return res += b; }
+    friend BigUInt operator-(const BigUInt& a, const BigUInt& b) { BigUInt res = a; return res -= b; }
+    friend BigUInt operator*(const BigUInt& a, uint64_t b) { BigUInt res = a; return res *= b; }
+    friend BigUInt operator*(uint64_t a, const BigUInt& b) { return b * a; }
+    friend BigUInt operator/(const BigUInt& a, const BigUInt& b) { return DivMod(a, b).first; }
+    friend BigUInt operator%(const BigUInt& a, const BigUInt& b) { return DivMod(a, b).second; }
+    friend BigUInt operator<<(const BigUInt& a, size_t n) { BigUInt res = a; return res <<= n; }
+    friend BigUInt operator>>(const BigUInt& a, size_t n) { BigUInt res = a; return res >>= n; }
+
+    friend BigUInt operator*(const BigUInt& a, const BigUInt& b) {
+        if(a.IsZero() || b.IsZero())
+            return BigUInt();
+
+        const size_t small = std::min(a.Size(), b.Size()), large = std::max(a.Size(), b.Size());
+        if(small >= Toom3Threshold && 3 * small >= 2 * large)
+            return __toom3(a, b);
+
+        BigUInt res;
+        res._Limbs.resize(a.Size() + b.Size());
+        __limbs_mul(res._Limbs.data(), a.Data(), a.Size(), b.Data(), b.Size());
+        res._normalize();
+        return res;
+    }
+
+    friend bool operator==(const BigUInt& a, const BigUInt& b) noexcept {
+        return a.Size() == b.Size() && std::equal(a.Data(), a.Data() + a.Size(), b.Data());
+    }
+
+    friend std::strong_ordering operator<=>(const BigUInt& a, const BigUInt& b) noexcept {
+        if(a.Size() != b.Size())
+            return a.Size() <=> b.Size();
+        for(size_t i = a.Size(); i-- > 0;)
+            if(a._Limbs[i] != b._Limbs[i])
+                return a._Limbs[i] <=> b._Limbs[i];
+        return std::strong_ordering::equal;
+    }
+
+    friend std::pair<BigUInt, BigUInt> DivMod(const BigUInt& a, const BigUInt& b);
+
+private:
+    void _normalize() noexcept {
+        size_t n = _Limbs.size();
+        while(n > 0 && _Limbs[n - 1] == 0) n--;
+        _Limbs.resize(n);
+    }
+
+    BigUInt _slice(size_t lo, size_t n) const {
+        if(lo >= Size())
+            return BigUInt();
+        return FromLimbs(Data() + lo, std::min(n, Size() - lo));
+    }
+
+    static BigUInt __toom3(const BigUInt& a, const BigUInt& b);
+    static std::pair<BigUInt, BigUInt> __divmod_knuth(const BigUInt& a, const BigUInt& b);
+    static std::pair<BigUInt, BigUInt> __divmod_newton(const BigUInt& a, const BigUInt& b);
+    static BigUInt __reciprocal(const BigUInt& d);
+    static BigUInt __extract_bits(const BigUInt& a, size_t lo, size_t n);
+
+    __limb_storage _Limbs;
+};
+
+// ############################################### TOOM-3 #########################################
+
+// A signed view for the evaluation/interpolation steps of Toom-3
+struct __signed_biguint {
+    BigUInt Mag;
+    bool Neg = false;
+};
+
+inline __signed_biguint operator+(const __signed_biguint& a, const __signed_biguint& b) {
+    if(a.Neg == b.Neg)
+        return { a.Mag + b.Mag, a.Neg };
+    if(a.Mag >= b.Mag)
+        return { a.Mag - b.Mag, a.Neg && a.Mag != b.Mag };
+    return { b.Mag - a.Mag, b.Neg };
+}
+
+inline __signed_biguint operator-(const __signed_biguint& a, const __signed_biguint& b) {
+    return a + __signed_biguint{ b.Mag, !b.Neg && !b.Mag.IsZero() };
+}
+
+inline __signed_biguint operator*(const __signed_biguint& a, const __signed_biguint& b) {
+    BigUInt m = a.Mag * b.Mag;
+    const bool neg = (a.Neg != b.Neg) && !m.IsZero();
+    return { std::move(m), neg };
+}
+
+// Exact division of a signed value by a single limb
+inline __signed_biguint __divexact(__signed_biguint a, uint64_t d) {
+    a.Mag.DivMod1(d);
+    return a;
+}
+
+inline BigUInt BigUInt::__toom3(const BigUInt& a, const BigUInt& b) {
+    using S = __signed_biguint;
+    const size_t k = (std::max(a.Size(), b.Size()) + 2) / 3;
+
+    auto evaluate = [k](const BigUInt& x, S& p0, S& p1, S& pm1, S& pm2, S& pinf) {
+        const S x0 = { x._slice(0, k) }, x1 = { x._slice(k, k) }, x2 = { x._slice(2 * k, k) };
+        const S t = x0 + x2;
+        p0 = x0, pinf = x2;
+        p1 = t + x1;
+        pm1 = t - x1;
+        pm2 = (pm1 + x2) + (pm1 + x2) - x0;
+    };
+
+    S a0, a1, am1, am2, ainf, b0, b1, bm1, bm2, binf;
+    evaluate(a, a0, a1, am1, am2, ainf);
+    evaluate(b, b0, b1, bm1, bm2, binf);
+
+    const S r0 = a0 * b0, r1 = a1 * b1, rm1 = am1 * bm1, rm2 = am2 * bm2, rinf = ainf * binf;
+
+    // Bodrato's interpolation sequence for the points 0, 1, -1, -2, inf
+    S c3 = __divexact(rm2 - r1, 3);
+    S c1 = __divexact(r1 - rm1, 2);
+    S c2 = rm1 - r0;
+    c3 = __divexact(c2 - c3, 2) + rinf + rinf;
+    c2 = c2 + c1 - rinf;
+    c1 = c1 - c3;
+
+    BigUInt res = rinf.Mag;
+    for(const S* c : std::array<const S*, 4>{ &c3, &c2, &c1, &r0 }) {
+        res <<= 64 * k;
+        res += c->Mag;
+    }
+    return res;
+}
+
+// ############################################### DIVISION #########################################
+
+inline std::pair<BigUInt, BigUInt> BigUInt::__divmod_knuth(const BigUInt& a, const BigUInt& b) {
+    const size_t n = b.Size(), m = a.Size();
+    const int s = std::countl_zero(b._Limbs[n - 1]);
+
+    BigUInt v = b << size_t(s), u = a << size_t(s);
+    u._Limbs.resize(m + 1);
+    const uint64_t* vn = v.Data();
+    uint64_t* un = u._Limbs.data();
+
+    BigUInt q;
+    q._Limbs.resize(m - n + 1);
+
+    for(size_t j = m - n + 1; j-- > 0;) {
+        uint64_t qhat, rhat;
+        bool rhat_overflow = false;
+        if(un[j + n] >= vn[n - 1]) {
+            qhat = ~uint64_t(0);
+            rhat = un[j + n - 1] + vn[n - 1];
+            rhat_overflow = rhat < vn[n - 1];
+        }
+        else qhat = __udiv128by64(un[j + n], un[j + n - 1], vn[n - 1], rhat);
+
+        while(!rhat_overflow && __umul128(qhat, vn[n - 2]) > uint128_t(rhat, un[j + n - 2])) {
+            qhat--;
+            rhat += vn[n - 1];
+            rhat_overflow = rhat < vn[n - 1];
+        }
+
+        const uint64_t borrow = __limbs_submul_1(un + j, vn, n, qhat);
+        const uint64_t top = un[j + n];
+        un[j + n] = top - borrow;
+        if(top < borrow) {
+            qhat--;
+            un[j + n] += __limbs_add(un + j, un + j, n, vn, n);
+        }
+        q._Limbs[j] = qhat;
+    }
+
+    q._normalize();
+    u._Limbs.resize(n);
+    u._normalize();
+    u >>= size_t(s);
+    return { std::move(q), std::move(u) };
+}
+
+// Bits [lo, lo + n) of a
+inline BigUInt BigUInt::__extract_bits(const BigUInt& a, size_t lo, size_t n) {
+    BigUInt res = a._slice(lo / 64, (n + 63) / 64 + 1);
+    res >>= lo % 64;
+    if(res.BitLength() > n) {
+        res._Limbs.resize((n + 63) / 64);
+        if(n % 64 != 0)
+            res._Limbs[res.Size() - 1] &= (uint64_t(1) << (n % 64)) - 1;
+        res._normalize();
+    }
+    return res;
+}
+
+/// floor(2^(2s) / d) for s = d.BitLength(), by a half-precision reciprocal followed by one Newton step
+inline BigUInt BigUInt::__reciprocal(const BigUInt& d) {
+    const size_t s = d.BitLength();
+    const BigUInt two = BigUInt(1) << (2 * s);
+
+    if(d.Size() <= NewtonThreshold)
+        return __divmod_knuth(two, d).first;
+
+    // Reciprocal of the top h bits, scaled up; the guard bits keep the Newton step within a few units
+    const size_t h = s / 2 + 64;
+    BigUInt x = __reciprocal(d >> (s - h)) << (s - h);
+
+    BigUInt p = d * x;
+    if(p <= two)
+        x += (x * (two - p)) >> (2 * s);
+    else {
+        const BigUInt dx = (x * (p - two)) >> (2 * s);
+        x -= dx + BigUInt(1) <= x ? dx + BigUInt(1) : x;
+    }
+
+    // Settle the last units exactly
+    p = d * x;
+    while(p > two)
+        p -= d, x -= BigUInt(1);
+    while(p + d <= two)
+        p += d, x += BigUInt(1);
+
+    return x;
+}
+
+inline std::pair<BigUInt, BigUInt> BigUInt::__divmod_newton(const BigUInt& a, const BigUInt& b) {
+    const size_t s = b.BitLength();
+    const BigUInt R = __reciprocal(b);
+
+    // Long division in base 2^s: every partial remainder x < b * 2^s has an s-bit quotient digit
+    const size_t chunks = (a.BitLength() + s - 1) / s;
+    BigUInt q, r;
+    q._Limbs.resize((chunks * s + 63) / 64);
+
+    for(size_t i = chunks; i-- > 0;) {
+        BigUInt x = (r << s) + __extract_bits(a, i * s, s);
+        BigUInt qi = (x * R) >> (2 * s);
+        BigUInt p = qi * b;
+        while(p > x)
+            p -= b, qi -= BigUInt(1);
+        r = x - p;
+        while(r >= b)
+            r -= b, qi += BigUInt(1);
+
+        // Deposit the digit at bit i * s; digits never overlap, so OR-ing by addition is exact
+        BigUInt shifted = qi << (i * s);
+        __limbs_add(q._Limbs.data(), q._Limbs.data(), q.Size(), shifted.Data(), shifted.Size());
+    }
+
+    q._normalize();
+    return { std::move(q), std::move(r) };
+}
+
+/// @brief Quotient and remainder of `a / b`.
+inline std::pair<BigUInt, BigUInt> DivMod(const BigUInt& a, const BigUInt& b) {
+    if(b.IsZero())
+        throw std::logic_error("Attempted to divide by zero");
+    if(a < b)
+        return { BigUInt(), a };
+
+    if(b.Size() == 1) {
+        BigUInt q = a;
+        const uint64_t r = q.DivMod1(b._Limbs[0]);
+        return { std::move(q), BigUInt(r) };
+    }
+
+    if(b.Size() < BigUInt::NewtonThreshold || a.Size() < b.Size() + BigUInt::NewtonThreshold / 2)
+        return BigUInt::__divmod_knuth(a, b);
+    return BigUInt::__divmod_newton(a, b);
+}
+
+// ############################################### DECIMAL CONVERSION #########################################
+
+constexpr uint64_t __pow10_19 = 10000000000000000000ull;
+
+/// @brief 10^(19 * 2^k), computed once per k and cached for the process.
+inline const BigUInt& __decimal_power(size_t k) {
+    static std::mutex mtx;
+    static std::deque<BigUInt> cache;
+
+    std::lock_guard lock(mtx);
+    if(cache.empty())
+        cache.emplace_back(__pow10_19);
+    while(cache.size() <= k)
+        cache.push_back(cache.back() * cache.back());
+    return cache[k];
+}
+
+// Append the digits of x, left-padded with zeros to `width` digits when width > 0
+inline void __to_decimal(const BigUInt& x, size_t k, size_t width, std::string& out) {
+    // Small values: peel off 19 digits at a time
+    if(x.Size() <= 8 || k == 0) {
+        std::vector<uint64_t> chunks;
+        BigUInt y = x;
+        while(!y.IsZero())
+            chunks.push_back(y.DivMod1(__pow10_19));
+
+        std::string digits;
+        for(size_t i = chunks.size(); i-- > 0;) {
+            std::string c = std::to_string(chunks[i]);
+            if(i + 1 != chunks.size())
+                c.insert(0, 19 - c.size(), '0');
+            digits += c;
+        }
+        if(width > digits.size())
+            out.append(width - digits.size(), '0');
+        out += digits;
+        return;
+    }
+
+    // Split by 10^(19 * 2^(k-1)); both halves then hold at most 19 * 2^(k-1) digits
+    const BigUInt& p = __decimal_power(k - 1);
+    auto [q, r] = DivMod(x, p);
+    const size_t half = 19 * (size_t(1) << (k - 1));
+    __to_decimal(q, k - 1, width > 0 ? width - half : 0, out);
+    __to_decimal(r, k - 1, half, out);
+}
+
+inline std::string BigUInt::ToString() const {
+    if(IsZero())
+        return "0";
+
+    // Smallest k with x < 10^(19 * 2^k)
+    size_t k = 0;
+    while(__decimal_power(k) <= *this)
+        k++;
+
+    std::string out;
+    __to_decimal(*this, k, 0, out);
+    return out;
+}
+
+inline BigUInt __from_decimal(std::string_view digits) {
+    constexpr size_t Base = 19 * 8;
+    if(digits.size() <= Base) {
+        BigUInt res;
+        for(size_t i = 0; i < digits.size(); i += 19) {
+            const size_t len = std::min<size_t>(19, digits.size() - i);
+            uint64_t chunk = 0, scale = 1;
+            for(size_t j = 0; j < len; j++)
+                chunk = chunk * 10 + uint64_t(digits[i + j] - '0'), scale *= 10;
+            res *= scale;
+            res += BigUInt(chunk);
+        }
+        return res;
+    }
+
+    // The low part takes the largest 19 * 2^k digits that leave a non-empty high part
+    size_t k = 0;
+    while(19 * (size_t(2) << k) < digits.size())
+        k++;
+    const size_t low = 19 * (size_t(1) << k);
+
+    BigUInt res = __from_decimal(digits.substr(0, digits.size() - low)) * __decimal_power(k);
+    return res += __from_decimal(digits.substr(digits.size() - low));
+}
+
+inline BigUInt::BigUInt(std::string_view decimal) {
+    if(decimal.empty() || !std::all_of(decimal.begin(), decimal.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        throw std::logic_error("Attempted to parse a BigUInt from a string that is not a decimal number");
+
+    *this = __from_decimal(decimal);
+}
+
+// ############################################### COMBINATORICS #########################################
+
+// Product of the integers in [lo, hi) by a balanced product tree
+inline BigUInt __range_product(uint64_t lo, uint64_t hi) {
+    if(hi - lo <= 16) {
+        BigUInt res(1);
+        for(uint64_t i = lo; i < hi; i++)
+            res *= i;
+        return res;
+    }
+    const uint64_t mid = lo + (hi - lo) / 2;
+    return __range_product(lo, mid) * __range_product(mid, hi);
+}
+
+inline BigUInt Factorial(uint64_t n) {
+    return __range_product(1, n + 1);
+}
+
+inline BigUInt Binomial(uint64_t n, uint64_t k) {
+    if(k > n)
+        return BigUInt();
+    k = std::min(k, n - k);
+    return __range_product(n - k + 1, n + 1) / __range_product(1, k + 1);
+}
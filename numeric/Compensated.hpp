@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "DoubleDouble.hpp"
+#include "other/Parallel.hpp"
+
+namespace Compensated {
+    /// @brief A contiguous range of floating-point values: spans, vectors, arrays.
+    template <class R>
+    concept FloatingRange = std::ranges::contiguous_range<R> && std::floating_point<std::ranges::range_value_t<R>>;
+
+    /**
+     * Elements per block. The block boundaries, the lane split inside a block and the order in which
+     * blocks are merged depend only on the length, so results are bitwise identical for any thread count.
+     */
+    constexpr size_t BlockSize = 1 << 14;
+
+    // Four 64-byte vectors of accumulators, enough independent chains to hide the add latency
+    template <std::floating_point T>
+    constexpr size_t __lanes = 256 / sizeof(T);
+
+    // A running sum with its accumulated rounding error
+    template <class T>
+    struct __partial {
+        T Sum = T(0), Err = T(0);
+    };
+
+    // Neumaier's compensation with the magnitude branch replaced by TwoSum, so that lanes need not branch
+    template <class D>
+    constexpr void __accumulate(D& s, D& c, const D& x) noexcept {
+        D e;
+        s = __two_sum(s, x, e);
+        c += e;
+    }
+
+    template <class T>
+    constexpr void __merge(__partial<T>& into, const __partial<T>& b) noexcept {
+        __accumulate(into.Sum, into.Err, b.Sum);
+        into.Err += b.Err;
+    }
+
+    // Fold the lane accumulators in lane order
+    template <class T, size_t W>
+    constexpr __partial<T> __fold_lanes(const T (&s)[W], const T (&c)[W]) noexcept {
+        __partial<T> res;
+        for(size_t l = 0; l < W; l++)
+            __merge(res, { s[l], c[l] });
+        return res;
+    }
+
+    // One fused loop over plain lane arrays, which the compiler keeps in vector registers
+    template <class T>
+    __partial<T> __sum_block(const T* x, size_t n) noexcept {
+        constexpr size_t W = __lanes<T>;
+        alignas(64) T s[W] = {}, c[W] = {};
+        const size_t full = n - n % W;
+        for(size_t i = 0; i < full; i += W)
+            for(size_t l = 0; l < W; l++)
+                __accumulate(s[l], c[l], x[i + l]);
+
+        __partial<T> res = __fold_lanes(s, c);
+        for(size_t i = full; i < n; i++)
+            __accumulate(res.Sum, res.Err, x[i]);
+        return res;
+    }
+
+    // Ogita, Rump and Oishi's Dot2: TwoProd for each product, TwoSum into the running sum
+    template <class T>
+    __partial<T> __dot_block(const T* x, const T* y, size_t n, T scale) noexcept {
+        constexpr size_t W = __lanes<T>;
+        alignas(64) T p[W] = {}, s[W] = {};
+        auto step = [scale](T& p, T& s, T a, T b) {
+            T r, q;
+            const T h = __two_prod(a * scale, b * scale, r);
+            p = __two_sum(p, h, q);
+            s += q + r;
+        };
+
+        const size_t full = n - n % W;
+        for(size_t i = 0; i < full; i += W)
+            for(size_t l = 0; l < W; l++)
+                step(p[l], s[l], x[i + l], y[i + l]);
+
+        __partial<T> res = __fold_lanes(p, s);
+        for(size_t i = full; i < n; i++)
+            step(res.Sum, res.Err, x[i], y[i]);
+        return res;
+    }
+
+    // Reduce [0, n) block by block, on several threads if asked, and merge the blocks in order
+    template <class T, class Block>
+    __partial<T> __reduce(size_t n, Block&& block, bool parallel) {
+        const size_t blocks = (n + BlockSize - 1) / BlockSize;
+        if(blocks <= 1)
+            return block(0, n);
+
+        std::vector<__partial<T>> partials(blocks);
+        auto run = [&](size_t b) {
+            const size_t lo = b * BlockSize;
+            partials[b] = block(lo, std::min(BlockSize, n - lo));
+        };
+
+        if(parallel)
+            ParallelFor(0, blocks, run, 16);
+        else for(size_t b = 0; b < blocks; b++)
+            run(b);
+
+        __partial<T> res;
+        for(const auto& b : partials)
+            __merge(res, b);
+        return res;
+    }
+
+    /**
+     * @brief Compensated sum (Kahan-Babuska-Neumaier), as accurate as summing in twice the precision
+     * and rounding once, for any length.
+     */
+    template <FloatingRange R>
+    auto Sum(const R& x, bool parallel = true) {
+        using T = std::ranges::range_value_t<R>;
+        const T* data = std::ranges::data(x);
+        const auto res = __reduce<T>(std::ranges::size(x), [data](size_t lo, size_t n) { return __sum_block(data + lo, n); }, parallel);
+        return res.Sum + res.Err;
+    }
+
+    /// @brief Compensated dot product (Ogita-Rump-Oishi Dot2), as if computed in twice the precision.
+    template <FloatingRange R, FloatingRange S>
+    requires std::same_as<std::ranges::range_value_t<R>, std::ranges::range_value_t<S>>
+    auto Dot(const R& x, const S& y, bool parallel = true) {
+        using T = std::ranges::range_value_t<R>;
+        if(std::ranges::size(x) != std::ranges::size(y))
+            throw std::logic_error("Attempted to take the dot product of ranges of different lengths");
+
+        const T *px = std::ranges::data(x), *py = std::ranges::data(y);
+        const auto res = __reduce<T>(std::ranges::size(x), [px, py](size_t lo, size_t n) { return __dot_block(px + lo, py + lo, n, T(1)); }, parallel);
+        return res.Sum + res.Err;
+    }
+
+    /**
+     * @brief Compensated Euclidean norm: Dot2 of the vector with itself and a correctly rounded square root.
+     * @note Sums of squares that overflow or lose precision to underflow are redone on values scaled by a
+     * power of two, which is exact.
+     */
+    template <FloatingRange R>
+    auto Norm2(const R& x, bool parallel = true) {
+        using T = std::ranges::range_value_t<R>;
+        const T* data = std::ranges::data(x);
+        const size_t n = std::ranges::size(x);
+
+        auto sum_of_squares = [&](T scale) {
+            return __reduce<T>(n, [data, scale](size_t lo, size_t m) { return __dot_block(data + lo, data + lo, m, scale); }, parallel);
+        };
+        auto root = [](const __partial<T>& sq) {
+            // Renormalise the pair before the double-double square root
+            T e;
+            const T s = __two_sum(sq.Sum, sq.Err, e);
+            return T(Sqrt(DoubleDouble(double(s), double(e))).Hi);
+        };
+
+        __partial<T> sq = sum_of_squares(T(1));
+        const T total = sq.Sum + sq.Err;
+        if(std::isfinite(total) && total >= std::numeric_limits<T>::min() / std::numeric_limits<T>::epsilon())
+            return root(sq);
+
+        // Scale the largest magnitude to [1, 2), or as close as a finite power of two gets for subnormals
+        T max_abs = 0;
+        for(size_t i = 0; i < n; i++)
+            max_abs = std::max(max_abs, std::abs(data[i]));
+        if(max_abs == 0 || !std::isfinite(max_abs))
+            return max_abs;
+
+        const int exponent = std::max(std::ilogb(max_abs), 2 - std::numeric_limits<T>::max_exponent);
+        sq = sum_of_squares(std::ldexp(T(1), -exponent));
+        return std::ldexp(root(sq), exponent);
+    }
+};
@@ -1,5 +1,16 @@
 #pragma once
 
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "Dual.hpp"
+#include "Matrices.hpp"
+#include "other/Parallel.hpp"
+
 namespace Differentiator {
     enum FDiffMode {
         Forward = 1, Backward = -1, Central = 0
@@ -16,4 +27,223 @@ namespace Differentiator {
                 return (f(x + h) - f(x - h))/(2.0 * h);
         }
     }
+
+    /// @brief Exact derivative of `f` at `x` by forward-mode AD; `f` must accept and return `Dual<T, 1>`.
+    template <class T, std::invocable<Dual<T, 1>> F>
+    constexpr T ADiff(F f, const T& x) {
+        return f(Dual<T, 1>::Variable(x, 0)).Partials[0];
+    }
+
+    /// @brief Exact gradient of `f : NVector<Dual<T, N>, N> -> Dual<T, N>` at `x` from a single evaluation.
+    template <class T, size_t N, std::invocable<NVector<Dual<T, N>, N>> F>
+    constexpr NVector<T, N> ADGradient(F f, const NVector<T, N>& x) {
+        NVector<Dual<T, N>, N> dx;
+        for(size_t i = 0; i < N; i++)
+            dx[i] = Dual<T, N>::Variable(x[i], i);
+
+        const Dual<T, N> fx = f(dx);
+        return NVector<T, N>(fx.Partials);
+    }
+
+    /// @brief Exact Jacobian of `f : NVector<Dual<T, N>, N> -> NVector<Dual<T, N>, M>` at `x` from a single evaluation.
+    template <size_t M, class T, size_t N, std::invocable<NVector<Dual<T, N>, N>> F>
+    constexpr Matrix<T, M, N> ADJacobian(F f, const NVector<T, N>& x) {
+        NVector<Dual<T, N>, N> dx;
+        for(size_t i = 0; i < N; i++)
+            dx[i] = Dual<T, N>::Variable(x[i], i);
+
+        const NVector<Dual<T, N>, M> fx = f(dx);
+        Matrix<T, M, N> J;
+        for(size_t i = 0; i < M; i++)
+            J[i] = NVector<T, N>(fx[i].Partials);
+
+        return J;
+    }
+
+    template <class T>
+    struct FDiffOptions {
+        FDiffMode Mode = Central;       // Ignored by FDHessian, which is always central
+        size_t RichardsonLevels = 0;    // Each level halves the steps and re-evaluates every perturbed point
+        bool Parallel = false;          // Evaluate the perturbed points concurrently; requires a thread-safe f
+    };
+
+    /// @brief A function that fills `ys[i] = f(xs[i])` for a whole span of points in one call.
+    template <class F, class T, size_t N, class R>
+    concept BatchField = std::invocable<F&, std::span<const NVector<T, N>>, std::span<R>>;
+
+    template <class F, class T, size_t N, class R>
+    concept Field = BatchField<F, T, N, R> || std::invocable<F&, const NVector<T, N>&>;
+
+    template <class R, class T, size_t N, Field<T, N, R> F>
+    void __fd_evaluate(F& f, std::span<const NVector<T, N>> xs, std::span<R> ys, bool parallel) {
+        if constexpr(BatchField<F, T, N, R>)
+            f(xs, ys);
+        else if(parallel)
+            ParallelFor(0, xs.size(), [&](size_t i) { ys[i] = f(xs[i]); });
+        else for(size_t i = 0; i < xs.size(); i++)
+            ys[i] = f(xs[i]);
+    }
+
+    // Per-coordinate step eps^(1/root) * max(|x_i|, 1), which balances truncation against rounding error.
+    // For a k-th derivative estimated to order p (after extrapolation), the balanced root is p + k.
+    template <class T, size_t N>
+    std::array<T, N> __fd_steps(const NVector<T, N>& x, int root) {
+        using std::abs, std::pow;
+        const T base = pow(std::numeric_limits<T>::epsilon(), T(1) / T(root));
+        std::array<T, N> h;
+        for(size_t i = 0; i < N; i++)
+            h[i] = base * std::max(abs(x[i]), T(1));
+        return h;
+    }
+
+    // Richardson extrapolation over estimates D[r] taken with step h / 2^r, for an error series in powers of 2^order
+    template <class R, class T>
+    R __richardson(std::vector<R>& D, const T& order_factor) {
+        T p = T(1);
+        for(size_t k = 1; k < D.size(); k++) {
+            p *= order_factor;
+            for(size_t r = D.size() - 1; r >= k; r--)
+                D[r] = (D[r] * p - D[r - 1]) / (p - T(1));
+        }
+        return D.back();
+    }
+
+    template <class R, class T, size_t N, Field<T, N, R> F>
+    std::array<R, N> __fd_first_derivatives(F& f, const NVector<T, N>& x, const FDiffOptions<T>& opts) {
+        const size_t levels = opts.RichardsonLevels + 1;
+        const size_t stride = (opts.Mode == Central ? 2 : 1) * N;
+        const int order = opts.Mode == Central ? 2 * int(levels) : int(levels);
+        const std::array<T, N> h = __fd_steps(x, order + 1);
+
+        // Every perturbed point of every level, followed by the shared base point for one-sided modes
+        std::vector<NVector<T, N>> xs(levels * stride + (opts.Mode == Central ? 0 : 1), x);
+        std::vector<T> denominators(levels * N);
+        for(size_t r = 0; r < levels; r++) {
+            for(size_t i = 0; i < N; i++) {
+                const T hr = std::ldexp(h[i], -int(r));
+                // Use the steps actually representable around x[i] rather than the nominal ones
+                const T xp = x[i] + hr, xm = x[i] - hr;
+                switch(opts.Mode) {
+                    case Forward:
+                        xs[r * stride + i][i] = xp, denominators[r * N + i] = xp - x[i];
+                        break;
+                    case Backward:
+                        xs[r * stride + i][i] = xm, denominators[r * N + i] = x[i] - xm;
+                        break;
+                    case Central:
+                        xs[r * stride + 2 * i][i] = xp, xs[r * stride + 2 * i + 1][i] = xm;
+                        denominators[r * N + i] = xp - xm;
+                        break;
+                }
+            }
+        }
+
+        std::vector<R> ys(xs.size());
+        __fd_evaluate<R>(f, std::span<const NVector<T, N>>(xs), std::span<R>(ys), opts.Parallel);
+
+        std::array<R, N> res;
+        std::vector<R> D(levels);
+        for(size_t i = 0; i < N; i++) {
+            for(size_t r = 0; r < levels; r++) {
+                const T& d = denominators[r * N + i];
+                switch(opts.Mode) {
+                    case Forward:
+                        D[r] = (ys[r * stride + i] - ys.back()) / d;
+                        break;
+                    case Backward:
+                        D[r] = (ys.back() - ys[r * stride + i]) / d;
+                        break;
+                    case Central:
+                        D[r] = (ys[r * stride + 2 * i] - ys[r * stride + 2 * i + 1]) / d;
+                        break;
+                }
+            }
+            res[i] = __richardson(D, opts.Mode == Central ? T(4) : T(2));
+        }
+
+        return res;
+    }
+
+    /**
+     * @brief Finite-difference gradient of a scalar field at `x`. All perturbed points (and the shared
+     * base point for one-sided modes) are evaluated in one batch, which goes to `f` in a single call
+     * if it accepts spans of points.
+     */
+    template <class T, size_t N, Field<T, N, T> F>
+    NVector<T, N> FDGradient(F f, const NVector<T, N>& x, const FDiffOptions<T>& opts = {}) {
+        return NVector<T, N>(__fd_first_derivatives<T>(f, x, opts));
+    }
+
+    /// @brief Finite-difference Jacobian of `f : NVector<T, N> -> NVector<T, M>` at `x`; see `FDGradient`.
+    template <size_t M, class T, size_t N, Field<T, N, NVector<T, M>> F>
+    Matrix<T, M, N> FDJacobian(F f, const NVector<T, N>& x, const FDiffOptions<T>& opts = {}) {
+        const auto cols = __fd_first_derivatives<NVector<T, M>>(f, x, opts);
+        Matrix<T, M, N> J;
+        for(size_t i = 0; i < M; i++)
+            for(size_t j = 0; j < N; j++)
+                J[i][j] = cols[j][i];
+
+        return J;
+    }
+
+    /// @brief Central finite-difference Hessian of a scalar field at `x`, sharing f(x) between all diagonal entries.
+    template <class T, size_t N, Field<T, N, T> F>
+    Matrix<T, N, N> FDHessian(F f, const NVector<T, N>& x, const FDiffOptions<T>& opts = {}) {
+        const size_t levels = opts.RichardsonLevels + 1;
+        const size_t pairs = N * (N - 1) / 2;
+        const size_t stride = 2 * N + 4 * pairs;
+        const std::array<T, N> h = __fd_steps(x, 2 * int(levels) + 2);
+
+        // Per level: x + h_i e_i, x - h_i e_i, then the four corners of each (i < j) pair; base point last
+        std::vector<NVector<T, N>> xs(levels * stride + 1, x);
+        std::vector<T> steps(levels * N);
+        for(size_t r = 0; r < levels; r++) {
+            const size_t base = r * stride;
+            for(size_t i = 0; i < N; i++) {
+                const T hr = std::ldexp(h[i], -int(r));
+                const T xp = x[i] + hr;
+                steps[r * N + i] = xp - x[i];
+                xs[base + i][i] = x[i] + steps[r * N + i];
+                xs[base + N + i][i] = x[i] - steps[r * N + i];
+            }
+
+            size_t k = base + 2 * N;
+            for(size_t i = 0; i < N; i++) {
+                for(size_t j = i + 1; j < N; j++, k += 4) {
+                    const T hi = steps[r * N + i], hj = steps[r * N + j];
+                    xs[k][i] += hi, xs[k][j] += hj;
+                    xs[k + 1][i] += hi, xs[k + 1][j] -= hj;
+                    xs[k + 2][i] -= hi, xs[k + 2][j] += hj;
+                    xs[k + 3][i] -= hi, xs[k + 3][j] -= hj;
+                }
+            }
+        }
+
+        std::vector<T> ys(xs.size());
+        __fd_evaluate<T>(f, std::span<const NVector<T, N>>(xs), std::span<T>(ys), opts.Parallel);
+        const T fx = ys.back();
+
+        Matrix<T, N, N> H;
+        std::vector<T> D(levels);
+        for(size_t i = 0; i < N; i++) {
+            for(size_t r = 0; r < levels; r++) {
+                const T hi = steps[r * N + i];
+                D[r] = (ys[r * stride + i] - T(2) * fx + ys[r * stride + N + i]) / (hi * hi);
+            }
+            H[i][i] = __richardson(D, T(4));
+        }
+
+        size_t k = 2 * N;
+        for(size_t i = 0; i < N; i++) {
+            for(size_t j = i + 1; j < N; j++, k += 4) {
+                for(size_t r = 0; r < levels; r++) {
+                    const T* y = &ys[r * stride + k];
+                    D[r] = ((y[0] - y[1]) - (y[2] - y[3])) / (T(4) * steps[r * N + i] * steps[r * N + j]);
+                }
+                H[i][j] = H[j][i] = __richardson(D, T(4));
+            }
+        }
+
+        return H;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "other/Misc.hpp"
+#include "Pack.hpp"
+
+// ############################################### ERROR-FREE TRANSFORMATIONS #########################################
+// Every routine is written once over a component type `D`, which is `double` for scalars or a
+// `Pack<double, W>` for W independent values at once.
+
+// s + e == a + b exactly, via the TwoSum in sum()
+template <class D>
+constexpr D __two_sum(const D& a, const D& b, D& e) {
+    e = D(0.0);
+    return sum(a, b, true, &e);
+}
+
+// s + e == a + b exactly, provided |a| >= |b|
+template <class D>
+constexpr D __quick_two_sum(const D& a, const D& b, D& e) noexcept {
+    const D s = a + b;
+    e = b - (s - a);
+    return s;
+}
+
+// The scalar type of each lane of D
+template <class D>
+struct __lane_type { using type = D; };
+
+template <class T, size_t W>
+struct __lane_type<Pack<T, W>> { using type = T; };
+
+// 2^ceil(p/2) + 1 for a p-bit significand: 134217729 for double, 4097 for float
+template <class D>
+inline constexpr typename __lane_type<D>::type __split_factor =
+    typename __lane_type<D>::type((uint64_t(1) << (std::numeric_limits<typename __lane_type<D>::type>::digits + 1) / 2) + 1);
+
+// Dekker's split of a into two halves of at most half the significand each
+template <class D>
+constexpr void __split(const D& a, D& hi, D& lo) noexcept {
+    const D t = a * __split_factor<D>;
+    hi = t - (t - a);
+    lo = a - hi;
+}
+
+// Without a hardware FMA, std::fma is a slow software routine and Dekker's product is the faster exact one
+#if defined(FP_FAST_FMA) || defined(__FMA__)
+    #define __DD_HAS_FAST_FMA 1
+#else
+    #define __DD_HAS_FAST_FMA 0
+#endif
+
+// p + e == a * b exactly; one FMA at runtime when the target has it, Dekker's product otherwise
+template <class D>
+constexpr D __two_prod(const D& a, const D& b, D& e) noexcept {
+    const D p = a * b;
+    if(std::is_constant_evaluated() || !__DD_HAS_FAST_FMA) {
+        D ah, al, bh, bl;
+        __split(a, ah, al), __split(b, bh, bl);
+        e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    }
+    else {
+        using std::fma;
+        e = fma(a, b, -p);
+    }
+    return p;
+}
+
+/**
+ * @brief An unevaluated sum `Hi + Lo` of two doubles with |Lo| <= ulp(Hi) / 2, carrying about 106 bits
+ * of significand. Arithmetic follows Hida, Li and Bailey's QD library (the IEEE-accurate variants).
+ * @note With `D = Pack<double, W>` the same code runs W values at once; such packs cannot be compared
+ * and do not handle overflow or zeros in `exp`/`log`, since lanes cannot branch.
+ */
+template <class D>
+class BasicDoubleDouble {
+public:
+    constexpr BasicDoubleDouble() noexcept : Hi(0.0), Lo(0.0) {}
+    constexpr BasicDoubleDouble(const D& hi) noexcept : Hi(hi), Lo(0.0) {}
+    constexpr BasicDoubleDouble(const D& hi, const D& lo) noexcept : Hi(hi), Lo(lo) {}
+
+    constexpr explicit operator D() const noexcept { return Hi; }
+
+    constexpr BasicDoubleDouble& operator+=(const BasicDoubleDouble& b) noexcept {
+        D e1, e2;
+        D s = __two_sum(Hi, b.Hi, e1);
+        const D t = __two_sum(Lo, b.Lo, e2);
+        e1 += t;
+        s = __quick_two_sum(s, e1, e1);
+        e1 += e2;
+        Hi = __quick_two_sum(s, e1, Lo);
+        return *this;
+    }
+
+    constexpr BasicDoubleDouble& operator+=(const D& b) noexcept {
+        D e;
+        const D s = __two_sum(Hi, b, e);
+        e += Lo;
+        Hi = __quick_two_sum(s, e, Lo);
+        return *this;
+    }
+
+    constexpr BasicDoubleDouble& operator-=(const BasicDoubleDouble& b) noexcept { return *this += -b; }
+    constexpr BasicDoubleDouble& operator-=(const D& b) noexcept { return *this += -b; }
+
+    constexpr BasicDoubleDouble& operator*=(const BasicDoubleDouble& b) noexcept {
+        D e;
+        const D p = __two_prod(Hi, b.Hi, e);
+        e += Hi * b.Lo + Lo * b.Hi;
+        Hi = __quick_two_sum(p, e, Lo);
+        return *this;
+    }
+
+    constexpr BasicDoubleDouble& operator*=(const D& b) noexcept {
+        D e;
+        const D p = __two_prod(Hi, b, e);
+        e += Lo * b;
+        Hi = __quick_two_sum(p, e, Lo);
+        return *this;
+    }
+
+    constexpr BasicDoubleDouble& operator/=(const BasicDoubleDouble& b) noexcept {
+        // Three rounds of long division by the leading digit
+        const D q1 = Hi / b.Hi;
+        BasicDoubleDouble r = *this - b * q1;
+        const D q2 = r.Hi / b.Hi;
+        r -= b * q2;
+        const D q3 = r.Hi / b.Hi;
+
+        D e;
+        const D q = __quick_two_sum(q1, q2, e);
+        return *this = BasicDoubleDouble(q, e) + q3;
+    }
+
+    constexpr BasicDoubleDouble& operator/=(const D& b) noexcept {
+        const D q1 = Hi / b;
+        D e1, e2;
+        const D p = __two_prod(q1, b, e1);
+        const D s = __two_sum(Hi, -p, e2);
+        e2 -= e1;
+        e2 += Lo;
+        const D q2 = (s + e2) / b;
+        Hi = __quick_two_sum(q1, q2, Lo);
+        return *this;
+    }
+
+    friend constexpr BasicDoubleDouble operator+(const BasicDoubleDouble& a) noexcept { return a; }
+    friend constexpr BasicDoubleDouble operator-(const BasicDoubleDouble& a) noexcept { return { -a.Hi, -a.Lo }; }
+
+    friend constexpr BasicDoubleDouble operator+(const BasicDoubleDouble& a, const BasicDoubleDouble& b) noexcept { BasicDoubleDouble res = a; return res += b; }
+    friend constexpr BasicDoubleDouble operator-(const BasicDoubleDouble& a, const BasicDoubleDouble& b) noexcept { BasicDoubleDouble res = a; return res -= b; }
+    friend constexpr BasicDoubleDouble operator*(const BasicDoubleDouble& a, const BasicDoubleDouble& b) noexcept { BasicDoubleDouble res = a; return res *= b; }
+    friend constexpr BasicDoubleDouble operator/(const BasicDoubleDouble& a, const BasicDoubleDouble& b) noexcept { BasicDoubleDouble res = a; return res /= b; }
+
+    friend constexpr BasicDoubleDouble operator+(const BasicDoubleDouble& a, const D& b) noexcept { BasicDoubleDouble res = a; return res += b; }
+    friend constexpr BasicDoubleDouble operator-(const BasicDoubleDouble& a, const D& b) noexcept { BasicDoubleDouble res = a; return res -= b; }
+    friend constexpr BasicDoubleDouble operator*(const BasicDoubleDouble& a, const D& b) noexcept { BasicDoubleDouble res = a; return res *= b; }
+    friend constexpr BasicDoubleDouble operator/(const BasicDoubleDouble& a, const D& b) noexcept { BasicDoubleDouble res = a; return res /= b; }
+
+    friend constexpr BasicDoubleDouble operator+(const D& a, const BasicDoubleDouble& b) noexcept { return b + a; }
+    friend constexpr BasicDoubleDouble operator-(const D& a, const BasicDoubleDouble& b) noexcept { return -b + a; }
+    friend constexpr BasicDoubleDouble operator*(const D& a, const BasicDoubleDouble& b) noexcept { return b * a; }
+    friend constexpr BasicDoubleDouble operator/(const D& a, const BasicDoubleDouble& b) noexcept { return BasicDoubleDouble(a) /= b; }
+
+    friend constexpr bool operator==(const BasicDoubleDouble& a, const BasicDoubleDouble& b) noexcept
+    requires std::floating_point<D> {
+        return a.Hi == b.Hi && a.Lo == b.Lo;
+    }
+
+    friend constexpr std::partial_ordering operator<=>(const BasicDoubleDouble& a, const BasicDoubleDouble& b) noexcept
+    requires std::floating_point<D> {
+        const auto hi_ord = a.Hi <=> b.Hi;
+        return hi_ord != 0 ? hi_ord : a.Lo <=> b.Lo;
+    }
+
+    D Hi, Lo;
+};
+
+using DoubleDouble = BasicDoubleDouble<double>;
+
+/// @brief W double-double values in SoA form (a pack of high parts and a pack of low parts).
+template <size_t W>
+using DoubleDoublePack = BasicDoubleDouble<Pack<double, W>>;
+
+template <>
+struct std::numeric_limits<DoubleDouble> {
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = false;
+    static constexpr bool has_infinity = true;
+    static constexpr bool has_quiet_NaN = true;
+    static constexpr int digits = 106;
+    static constexpr int digits10 = 31;
+    static constexpr int radix = 2;
+
+    static constexpr DoubleDouble epsilon() noexcept { return 0x1p-104; }
+    static constexpr DoubleDouble min() noexcept { return std::numeric_limits<double>::min(); }
+    static constexpr DoubleDouble max() noexcept { return { 1.79769313486231570815e+308, 9.97920154767359795037e+291 }; }
+    static constexpr DoubleDouble lowest() noexcept { return -max(); }
+    static constexpr DoubleDouble infinity() noexcept { return std::numeric_limits<double>::infinity(); }
+    static constexpr DoubleDouble quiet_NaN() noexcept { return std::numeric_limits<double>::quiet_NaN(); }
+};
+
+// ############################################### FUNCTIONS #########################################
+
+// 1/k! for k = 0, ..., 9
+constexpr std::array<DoubleDouble, 10> __dd_inv_factorials = []() {
+    std::array<DoubleDouble, 10> res;
+    double f = 1.0;
+    for(size_t k = 0; k < res.size(); k++) {
+        f *= k > 0 ? double(k) : 1.0;
+        res[k] = DoubleDouble(1.0) / f;
+    }
+    return res;
+}();
+
+template <class D>
+constexpr BasicDoubleDouble<D> abs(const BasicDoubleDouble<D>& a) noexcept
+requires std::floating_point<D> {
+    return a.Hi < 0 ? -a : a;
+}
+
+/// @brief Square root by one Newton step from the double root (Karp's trick).
+template <class D>
+constexpr BasicDoubleDouble<D> Sqrt(const BasicDoubleDouble<D>& a) noexcept {
+    using std::sqrt;
+    if constexpr(std::floating_point<D>) {
+        if(a.Hi <= 0)
+            return a.Hi == 0 ? a : std::numeric_limits<BasicDoubleDouble<D>>::quiet_NaN();
+    }
+
+    D root;
+    if constexpr(std::floating_point<D>)
+        root = std::is_constant_evaluated() ? Sqrt(a.Hi) : sqrt(a.Hi);
+    else
+        root = sqrt(a.Hi);
+
+    const D x = D(1.0) / root;
+    const D ax = a.Hi * x;
+    BasicDoubleDouble<D> res = a - BasicDoubleDouble<D>(ax) * ax;
+    res = BasicDoubleDouble<D>(ax) + res.Hi * (x * 0.5);
+
+    if constexpr(!std::floating_point<D>) {
+        // Zero lanes would otherwise come out as 0 * inf
+        for(size_t i = 0; i < std::size(a.Hi.Lanes); i++)
+            if(a.Hi[i] == 0)
+                res.Hi[i] = 0, res.Lo[i] = 0;
+    }
+    return res;
+}
+
+template <class D>
+constexpr BasicDoubleDouble<D> sqrt(const BasicDoubleDouble<D>& a) noexcept {
+    return Sqrt(a);
+}
+
+/// @brief e^a by reducing to |r| <= ln(2) / 1024, a degree-9 Taylor polynomial and nine squarings.
+template <class D>
+BasicDoubleDouble<D> exp(const BasicDoubleDouble<D>& a) noexcept {
+    using std::floor, std::exp2;
+    using DD = BasicDoubleDouble<D>;
+    constexpr DoubleDouble ln2 = { 6.931471805599452862e-01, 2.319046813846299558e-17 };
+
+    if constexpr(std::floating_point<D>) {
+        if(a.Hi > 709.782712893384)
+            return std::numeric_limits<DD>::infinity();
+        if(a.Hi < -745.2)
+            return DD();
+    }
+
+    // a = m ln2 + 512 r
+    const D m = floor(a.Hi / ln2.Hi + 0.5);
+    const DD r = (a - DD(D(ln2.Hi), D(ln2.Lo)) * m) * D(1.0 / 512.0);
+
+    // s = e^r - 1, by Horner over the inverse factorials
+    DD s = DD(D(__dd_inv_factorials[9].Hi), D(__dd_inv_factorials[9].Lo));
+    for(size_t k = 9; k-- > 1;)
+        s = s * r + DD(D(__dd_inv_factorials[k].Hi), D(__dd_inv_factorials[k].Lo));
+    s *= r;
+
+    // (1 + s)^2 - 1 = 2s + s^2, keeping the small quantity until the end
+    for(int i = 0; i < 9; i++)
+        s = s * D(2.0) + s * s;
+    s += D(1.0);
+
+    // Split the scaling so that neither factor overflows on its own near the ends of the range
+    const D m1 = floor(m * D(0.5));
+    const D scale1 = exp2(m1), scale2 = exp2(m - m1);
+    return { s.Hi * scale1 * scale2, s.Lo * scale1 * scale2 };
+}
+
+/// @brief Natural logarithm by one Newton step x + a e^-x - 1 from the double logarithm.
+template <class D>
+BasicDoubleDouble<D> log(const BasicDoubleDouble<D>& a) noexcept {
+    using std::log;
+    using DD = BasicDoubleDouble<D>;
+
+    if constexpr(std::floating_point<D>) {
+        if(a.Hi <= 0)
+            return a.Hi == 0 ? -std::numeric_limits<DD>::infinity() : std::numeric_limits<DD>::quiet_NaN();
+    }
+
+    const DD x = D(log(a.Hi));
+    return x + a * exp(-x) - D(1.0);
+}
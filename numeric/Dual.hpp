@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <immintrin.h>
+#include <type_traits>
+
+#include "other/Misc.hpp"
+
+// res[i] = alpha * x[i] + beta * y[i]; every derivative rule below reduces to this kernel.
+// res may alias x or y.
+template <class T, size_t N>
+constexpr void __dual_lanes_axpby(std::array<T, N>& res, const T& alpha, const std::array<T, N>& x, const T& beta, const std::array<T, N>& y) noexcept {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    if constexpr(std::same_as<T, double> && N >= 8) {
+        if(!std::is_constant_evaluated()) {
+            const __m512d a = _mm512_set1_pd(alpha), b = _mm512_set1_pd(beta);
+            for(; i + 8 <= N; i += 8)
+                _mm512_storeu_pd(&res[i], _mm512_add_pd(_mm512_mul_pd(a, _mm512_loadu_pd(&x[i])), _mm512_mul_pd(b, _mm512_loadu_pd(&y[i]))));
+        }
+    }
+#endif
+#if defined(__AVX__)
+    if constexpr(std::same_as<T, double> && N >= 4) {
+        if(!std::is_constant_evaluated()) {
+            const __m256d a = _mm256_set1_pd(alpha), b = _mm256_set1_pd(beta);
+            for(; i + 4 <= N; i += 4)
+                _mm256_storeu_pd(&res[i], _mm256_add_pd(_mm256_mul_pd(a, _mm256_loadu_pd(&x[i])), _mm256_mul_pd(b, _mm256_loadu_pd(&y[i]))));
+        }
+    }
+#endif
+    for(; i < N; i++)
+        res[i] = alpha * x[i] + beta * y[i];
+}
+
+// res[i] = alpha * x[i]; res may alias x.
+template <class T, size_t N>
+constexpr void __dual_lanes_scale(std::array<T, N>& res, const T& alpha, const std::array<T, N>& x) noexcept {
+    size_t i = 0;
+#if defined(__AVX__)
+    if constexpr(std::same_as<T, double> && N >= 4) {
+        if(!std::is_constant_evaluated()) {
+            const __m256d a = _mm256_set1_pd(alpha);
+            for(; i + 4 <= N; i += 4)
+                _mm256_storeu_pd(&res[i], _mm256_mul_pd(a, _mm256_loadu_pd(&x[i])));
+        }
+    }
+#endif
+    for(; i < N; i++)
+        res[i] = alpha * x[i];
+}
+
+/**
+ * @brief A forward-mode automatic differentiation number carrying a value and `N` partial derivatives.
+ * @tparam T the underlying scalar type
+ * @tparam N the number of derivative lanes, i.e. the number of independent variables seeded at once
+ * @note Comparisons only look at `Value`, so control flow follows the primal computation.
+ */
+template <class T, size_t N>
+class Dual {
+public:
+    constexpr Dual() noexcept : Value(0), Partials({}) {}
+    constexpr Dual(const T& val) noexcept : Value(val), Partials({}) {}
+    constexpr Dual(const T& val, const std::array<T, N>& partials) noexcept : Value(val), Partials(partials) {}
+
+    /// @brief Create the `i`-th independent variable with value `val`.
+    static constexpr Dual Variable(const T& val, size_t i) noexcept {
+        Dual res(val);
+        res.Partials[i] = T(1);
+        return res;
+    }
+
+    constexpr Dual& operator+=(const Dual& b) noexcept {
+        Value += b.Value;
+        __dual_lanes_axpby(Partials, T(1), Partials, T(1), b.Partials);
+        return *this;
+    }
+
+    constexpr Dual& operator-=(const Dual& b) noexcept {
+        Value -= b.Value;
+        __dual_lanes_axpby(Partials, T(1), Partials, T(-1), b.Partials);
+        return *this;
+    }
+
+    constexpr Dual& operator*=(const Dual& b) noexcept {
+        __dual_lanes_axpby(Partials, b.Value, Partials, Value, b.Partials);
+        Value *= b.Value;
+        return *this;
+    }
+
+    constexpr Dual& operator/=(const Dual& b) noexcept {
+        const T inv = T(1) / b.Value;
+        Value *= inv;
+        __dual_lanes_axpby(Partials, inv, Partials, -Value * inv, b.Partials);
+        return *this;
+    }
+
+    constexpr Dual& operator+=(const T& b) noexcept { Value += b; return *this; }
+    constexpr Dual& operator-=(const T& b) noexcept { Value -= b; return *this; }
+
+    constexpr Dual& operator*=(const T& b) noexcept {
+        Value *= b;
+        __dual_lanes_scale(Partials, b, Partials);
+        return *this;
+    }
+
+    constexpr Dual& operator/=(const T& b) noexcept {
+        return *this *= T(1) / b;
+    }
+
+    friend constexpr Dual operator+(const Dual& a) noexcept { return a; }
+
+    friend constexpr Dual operator-(const Dual& a) noexcept {
+        Dual res = a;
+        res.Value = -a.Value;
+        __dual_lanes_scale(res.Partials, T(-1), a.Partials);
+        return res;
+    }
+
+    friend constexpr Dual operator+(const Dual& a, const Dual& b) noexcept { Dual res = a; return res += b; }
+    friend constexpr Dual operator-(const Dual& a, const Dual& b) noexcept { Dual res = a; return res -= b; }
+    friend constexpr Dual operator*(const Dual& a, const Dual& b) noexcept { Dual res = a; return res *= b; }
+    friend constexpr Dual operator/(const Dual& a, const Dual& b) noexcept { Dual res = a; return res /= b; }
+
+    friend constexpr Dual operator+(const Dual& a, const T& b) noexcept { Dual res = a; return res += b; }
+    friend constexpr Dual operator-(const Dual& a, const T& b) noexcept { Dual res = a; return res -= b; }
+    friend constexpr Dual operator*(const Dual& a, const T& b) noexcept { Dual res = a; return res *= b; }
+    friend constexpr Dual operator/(const Dual& a, const T& b) noexcept { Dual res = a; return res /= b; }
+
+    friend constexpr Dual operator+(const T& a, const Dual& b) noexcept { return b + a; }
+    friend constexpr Dual operator-(const T& a, const Dual& b) noexcept { return -b + a; }
+    friend constexpr Dual operator*(const T& a, const Dual& b) noexcept { return b * a; }
+
+    friend constexpr Dual operator/(const T& a, const Dual& b) noexcept {
+        const T inv = T(1) / b.Value;
+        Dual res;
+        res.Value = a * inv;
+        __dual_lanes_scale(res.Partials, -res.Value * inv, b.Partials);
+        return res;
+    }
+
+    friend constexpr bool operator==(const Dual& a, const Dual& b) noexcept { return a.Value == b.Value; }
+    friend constexpr auto operator<=>(const Dual& a, const Dual& b) noexcept { return a.Value <=> b.Value; }
+
+    T Value;
+    alignas(sizeof(T) * N >= 32 ? 32 : alignof(T)) std::array<T, N> Partials;
+};
+
+// ############################################### ELEMENTARY FUNCTIONS FOR Dual #########################################
+
+// Apply the chain rule for a unary function with value fx and derivative dfx at a.Value
+template <class T, size_t N>
+constexpr Dual<T, N> __dual_chain(const Dual<T, N>& a, const T& fx, const T& dfx) noexcept {
+    Dual<T, N> res(fx);
+    __dual_lanes_scale(res.Partials, dfx, a.Partials);
+    return res;
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> sqrt(const Dual<T, N>& a) {
+    using std::sqrt;
+    const T s = sqrt(a.Value);
+    return __dual_chain(a, s, T(0.5) / s);
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> exp(const Dual<T, N>& a) {
+    using std::exp;
+    const T e = exp(a.Value);
+    return __dual_chain(a, e, e);
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> log(const Dual<T, N>& a) {
+    using std::log;
+    return __dual_chain(a, log(a.Value), T(1) / a.Value);
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> sin(const Dual<T, N>& a) {
+    using std::sin, std::cos;
+    return __dual_chain(a, sin(a.Value), cos(a.Value));
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> cos(const Dual<T, N>& a) {
+    using std::sin, std::cos;
+    return __dual_chain(a, cos(a.Value), -sin(a.Value));
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> tan(const Dual<T, N>& a) {
+    using std::tan;
+    const T t = tan(a.Value);
+    return __dual_chain(a, t, T(1) + t * t);
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> atan(const Dual<T, N>& a) {
+    using std::atan;
+    return __dual_chain(a, atan(a.Value), T(1) / (T(1) + a.Value * a.Value));
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> sinh(const Dual<T, N>& a) {
+    using std::sinh, std::cosh;
+    return __dual_chain(a, sinh(a.Value), cosh(a.Value));
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> cosh(const Dual<T, N>& a) {
+    using std::sinh, std::cosh;
+    return __dual_chain(a, cosh(a.Value), sinh(a.Value));
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> tanh(const Dual<T, N>& a) {
+    using std::tanh;
+    const T t = tanh(a.Value);
+    return __dual_chain(a, t, T(1) - t * t);
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> abs(const Dual<T, N>& a) {
+    return a.Value >= T(0) ? a : -a;
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> pow(const Dual<T, N>& a, const T& p) {
+    using std::pow;
+    // The value on its own, since pow(0, p - 1) * 0 is NaN for 0 < p < 1 where pow(0, p) is 0
+    return __dual_chain(a, pow(a.Value, p), p * pow(a.Value, p - T(1)));
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> pow(const Dual<T, N>& a, const Dual<T, N>& b) {
+    return exp(b * log(a));
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> atan2(const Dual<T, N>& y, const Dual<T, N>& x) {
+    using std::atan2;
+    const T r2 = x.Value * x.Value + y.Value * y.Value;
+    Dual<T, N> res(atan2(y.Value, x.Value));
+    __dual_lanes_axpby(res.Partials, x.Value / r2, y.Partials, -y.Value / r2, x.Partials);
+    return res;
+}
+
+// Overloads of the generic helpers from Misc.hpp
+template <class T, size_t N>
+constexpr Dual<T, N> Abs(Dual<T, N> x) noexcept {
+    return abs(x);
+}
+
+template <class T, size_t N>
+constexpr Dual<T, N> Sqrt(Dual<T, N> a) noexcept {
+    const T s = Sqrt(a.Value);
+    return __dual_chain(a, s, T(0.5) / s);
+}
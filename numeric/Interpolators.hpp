@@ -1,52 +1,109 @@
 #pragma once
 
 #include <cmath>
+#include <memory>
 #include <numbers>
+#include <span>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 #include "Polynomial.hpp"
+#include "other/Parallel.hpp"
 
 namespace Interpolator {
-    template <class T, std::invocable<T> F>
-    std::vector<std::pair<T, T>> CreateChebyshevNodes(F f, const T& start_point, const T& end_point, size_t n) {
+    /// @brief Allocator of the T values that accompany a node vector with allocator A, on the same resource.
+    template <class T, class A>
+    using NodeValueAllocator = typename std::allocator_traits<A>::template rebind_alloc<T>;
+
+    // Evaluate f at the abscissae already in nodes, on pool if one is given
+    template <class T, class F, class A>
+    void __sample_nodes(std::vector<std::pair<T, T>, A>& nodes, F& f, ThreadPool* pool) {
+        if(pool == nullptr) {
+            for(auto& [x, y] : nodes)
+                y = f(x);
+            return;
+        }
+
+        ParallelFor(*pool, 0, nodes.size(), [&](size_t k) { nodes[k].second = f(nodes[k].first); }, DefaultGrain(*pool, nodes.size()));
+    }
+
+    template <class T, class A>
+    std::vector<std::pair<T, T>, A> __chebyshev_abscissae(const T& start_point, const T& end_point, size_t n, const A& alloc) {
         T centre_point = (start_point + end_point) * 0.5;
         T interval = end_point - centre_point;
-        std::vector<std::pair<T, T>> res(n);
+        std::vector<std::pair<T, T>, A> res(n, alloc);
         using namespace std::numbers;
 
-        for(size_t k = 0; k < n; k++) {
+        for(size_t k = 0; k < n; k++)
             res[k].first = centre_point + interval * cos(k/(n - 1.0) * pi);
-            res[k].second = f(res[k].first);
-        }
 
         return res;
     }
 
-    template <class T, std::invocable<T> F>
-    constexpr std::vector<std::pair<T, T>> CreateEquidistantNodes(F f, const T& start_point, const T& end_point, size_t n) {
+    template <class T, class A>
+    constexpr std::vector<std::pair<T, T>, A> __equidistant_abscissae(const T& start_point, const T& end_point, size_t n, const A& alloc) {
         if(n < 2) throw std::logic_error("Attempted to create less than two nodes on an interval");
 
-        std::vector<std::pair<T, T>> res(n);
-        T interval_between = (end_point - start_point) / (n - 1);
+        std::vector<std::pair<T, T>, A> res(n, alloc);
 
-        for(size_t k = 0; k < n; k++) {
-            res[k].first = start_point + k * interval_between;
-            res[k].second = f(res[k].first);
-        }
+        // Weighted from both ends, so the end points are exact and symmetric nodes of a symmetric interval
+        // cancel exactly, with or without contraction into FMAs
+        for(size_t k = 0; k < n; k++)
+            res[k].first = (start_point * (n - 1 - k) + end_point * k) / (n - 1);
+
+        return res;
+    }
+
+    template <class T, std::invocable<T> F, class A = std::allocator<std::pair<T, T>>>
+    std::vector<std::pair<T, T>, A> CreateChebyshevNodes(F f, const T& start_point, const T& end_point, size_t n, const A& alloc = A()) {
+        __INSTRUMENT_OP("Interpolator::CreateChebyshevNodes");
+        auto res = __chebyshev_abscissae(start_point, end_point, n, alloc);
+        __sample_nodes(res, f, nullptr);
+        return res;
+    }
+
+    /// @brief Chebyshev nodes with f evaluated on pool; f must be safe to call concurrently.
+    template <class T, std::invocable<T> F, class A = std::allocator<std::pair<T, T>>>
+    std::vector<std::pair<T, T>, A> CreateChebyshevNodes(ThreadPool& pool, F f, const T& start_point, const T& end_point, size_t n, const A& alloc = A()) {
+        __INSTRUMENT_OP("Interpolator::CreateChebyshevNodes");
+        auto res = __chebyshev_abscissae(start_point, end_point, n, alloc);
+        __sample_nodes(res, f, &pool);
+        return res;
+    }
 
+    template <class T, std::invocable<T> F, class A = std::allocator<std::pair<T, T>>>
+    constexpr std::vector<std::pair<T, T>, A> CreateEquidistantNodes(F f, const T& start_point, const T& end_point, size_t n, const A& alloc = A()) {
+        __INSTRUMENT_OP("Interpolator::CreateEquidistantNodes");
+        auto res = __equidistant_abscissae(start_point, end_point, n, alloc);
+        for(auto& [x, y] : res)
+            y = f(x);
+        return res;
+    }
+
+    /// @brief Equidistant nodes with f evaluated on pool; f must be safe to call concurrently.
+    template <class T, std::invocable<T> F, class A = std::allocator<std::pair<T, T>>>
+    std::vector<std::pair<T, T>, A> CreateEquidistantNodes(ThreadPool& pool, F f, const T& start_point, const T& end_point, size_t n, const A& alloc = A()) {
+        __INSTRUMENT_OP("Interpolator::CreateEquidistantNodes");
+        auto res = __equidistant_abscissae(start_point, end_point, n, alloc);
+        __sample_nodes(res, f, &pool);
         return res;
     }
 };
 
 namespace Interpolator::Lagrange {
-    template <class T>
-    constexpr Polynomial<T> ComputePolynomial(const std::vector<std::pair<T, T>>& points) {
-        Polynomial<T> res;
-        Polynomial<T> base = {0.0};
-        Polynomial<T> mult = {0.0, 0.0};
+    /// @note The polynomial and its intermediates are allocated like the nodes.
+    template <class T, class A>
+    constexpr Polynomial<T, NodeValueAllocator<T, A>> ComputePolynomial(const std::vector<std::pair<T, T>, A>& points) {
+        using P = Polynomial<T, NodeValueAllocator<T, A>>;
+        const NodeValueAllocator<T, A> alloc(points.get_allocator());
+        __INSTRUMENT_OP("Interpolator::Lagrange::ComputePolynomial");
+
+        P res(alloc);
+        P base = P({0.0}, alloc);
+        P mult = P({0.0, 0.0}, alloc);
 
-        res.Coefficients = std::vector<T>(points.size());
-        res.Coefficients.clear();
+        res.Coefficients.reserve(points.size());
 
         // Iterate through all Lagrange bases
         for(size_t i = 0; i < points.size(); i++) {
@@ -65,37 +122,105 @@ namespace Interpolator::Lagrange {
                     base /= (xi - xj);
                 }
             }
-            res += base * yi;
+            base *= yi;
+            res += base;
         }
 
         return res;
     }
 
+    // The barycentric weights 1 / prod_{j != i} (x_i - x_j) of the abscissae xs, into weights
+    template <class T>
+    constexpr void __barycentric_weights(std::span<const T> xs, std::span<T> weights) {
+        __INSTRUMENT_FLOPS(2 * xs.size() * xs.size());
+        std::fill(weights.begin(), weights.end(), T(1.0));
+        for(size_t i = 0; i < xs.size(); i++)
+            for(size_t j = 0; j < xs.size(); j++)
+                if(i == j) continue;
+                else weights[i] /= xs[i] - xs[j];
+    }
+
     template <class T>
-    constexpr auto CreateBarycentricInterpolator(const std::vector<std::pair<T, T>>& points) {
-        return [=, weights = std::vector<T>(points.size()), cp_points = points, precomputed_weights=false](T x) mutable -> T {
+    constexpr T __barycentric_evaluate(std::span<const T> xs, std::span<const T> ys, std::span<const T> weights, const T& x) {
+        __INSTRUMENT_FLOPS(4 * xs.size() + 1);
+        T numerator = T(0.0);
+        T denominator = T(0.0);
+        T holder = T(0.0);
+        for(size_t i = 0; i < xs.size(); i++) {
+            holder = weights[i] / (x - xs[i]);
+            numerator += holder * ys[i];
+            denominator += holder;
+        }
+
+        return numerator / denominator;
+    }
+
+    /// @brief The barycentric weights of the abscissae of points, allocated like the nodes.
+    template <class T, class A>
+    constexpr std::vector<T, NodeValueAllocator<T, A>> ComputeBarycentricWeights(const std::vector<std::pair<T, T>, A>& points) {
+        const NodeValueAllocator<T, A> alloc(points.get_allocator());
+        __INSTRUMENT_OP("Interpolator::Lagrange::ComputeBarycentricWeights");
+
+        std::vector<T, NodeValueAllocator<T, A>> xs(alloc), res(points.size(), alloc);
+        xs.reserve(points.size());
+        for(const auto& [x, y] : points)
+            xs.push_back(x);
+
+        __barycentric_weights<T>(xs, res);
+        return res;
+    }
+
+    /// @note The copies of the nodes and the weights held by the interpolator are allocated like the nodes.
+    template <class T, class A>
+    constexpr auto CreateBarycentricInterpolator(const std::vector<std::pair<T, T>, A>& points) {
+        using value_vector = std::vector<T, NodeValueAllocator<T, A>>;
+        const NodeValueAllocator<T, A> alloc(points.get_allocator());
+        __INSTRUMENT_OP("Interpolator::Lagrange::CreateBarycentricInterpolator");
+
+        value_vector xs(alloc), ys(alloc);
+        xs.reserve(points.size()), ys.reserve(points.size());
+        for(const auto& [x, y] : points)
+            xs.push_back(x), ys.push_back(y);
+
+        return [weights = value_vector(points.size(), alloc), xs = std::move(xs), ys = std::move(ys), precomputed_weights=false](T x) mutable -> T {
+            __INSTRUMENT_OP("Interpolator::Lagrange::BarycentricEvaluate");
             if(!precomputed_weights) {
-                std::fill(weights.begin(), weights.end(), T(1.0));
-                for(size_t i = 0; i < cp_points.size(); i++)
-                    for(size_t j = 0; j < cp_points.size(); j++)
-                        if(i == j) continue;
-                        else weights[i] /= cp_points[i].first - cp_points[j].first;
-                
+                __barycentric_weights<T>(xs, weights);
                 precomputed_weights = true;
             }
 
-            T numerator = T(0.0);
-            T denominator = T(0.0);
-            T holder = T(0.0);
-            for(size_t i = 0; i < cp_points.size(); i++) {
-                holder = weights[i] / (x - cp_points[i].first);
-                numerator += holder * cp_points[i].second;
-                denominator += holder;
-            }
-
-            return numerator / denominator;
+            return __barycentric_evaluate<T>(xs, ys, weights, x);
         };
     }
+
+    /**
+     * @brief A non-owning barycentric interpolant over nodes and weights stored elsewhere, such as those of a
+     * mapped table file (see numeric/Tables.hpp), so nothing is sampled or weighed again. It evaluates exactly
+     * like the interpolator from CreateBarycentricInterpolator on the same nodes.
+     * @note The arrays must outlive the view.
+     */
+    template <class T>
+    class BarycentricView {
+    public:
+        constexpr BarycentricView() noexcept = default;
+        constexpr BarycentricView(std::span<const T> xs, std::span<const T> ys, std::span<const T> weights) : X(xs), Y(ys), Weights(weights) {
+            if(ys.size() != xs.size() || weights.size() != xs.size())
+                throw std::logic_error("Attempted to create a barycentric interpolant from arrays of different lengths");
+        }
+
+        constexpr T operator()(const T& x) const {
+            __INSTRUMENT_OP("Interpolator::Lagrange::BarycentricView::operator()");
+            return __barycentric_evaluate(X, Y, Weights, x);
+        }
+
+        constexpr size_t Size() const noexcept {
+            return X.size();
+        }
+
+        std::span<const T> X;
+        std::span<const T> Y;
+        std::span<const T> Weights;
+    };
 };
 
 namespace Interpolator::Trigonometric {
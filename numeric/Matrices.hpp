@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <immintrin.h>
+#include <type_traits>
 
 #include "other/Misc.hpp"
+#include "other/Parallel.hpp"
 
 template <class T, size_t N>
 class NVector {
@@ -104,34 +107,65 @@ protected:
     std::array<NVector<T, M>, N> _Elems;
 };
 
+// Products of at least this many multiply-adds are split by rows of the result across the default pool
+inline constexpr size_t __matmul_parallel_threshold = size_t(1) << 18;
+
+// Eliminations on matrices of at least this order update the rows below the pivot on the default pool
+inline constexpr size_t __det_parallel_threshold = 128;
+
 template <class T, size_t N, size_t M, size_t P>
 Matrix<T, N, P> MatrixMul(const Matrix<T, N, M>& A, const Matrix<T, M, P>& B) {
+    __INSTRUMENT_OP("MatrixMul");
+    __INSTRUMENT_FLOPS(2 * N * M * P);
     Matrix<T, N, P> C;
-    for(size_t i = 0; i < N; i++)
-        C[i] = FOLD(Ns, N, (A[i][Ns] * B[Ns]) + ...);
+    auto compute_row = [&](size_t i) {
+        for(size_t k = 0; k < M; k++)
+            C[i] += B[k] * A[i][k];
+    };
+
+    if constexpr(N * M * P >= __matmul_parallel_threshold)
+        ParallelFor(0, N, compute_row, std::max<size_t>(1, __matmul_parallel_threshold / (M * P)));
+    else
+        for(size_t i = 0; i < N; i++)
+            compute_row(i);
 
     return C;
 }
 
 template <class T, size_t N>
 constexpr T Det(const Matrix<T, N, N>& M) {
+    __INSTRUMENT_OP("Det");
+    __INSTRUMENT_FLOPS((2 * N * N * N + 3 * N * N) / 3);
     Matrix<T, N, N> cp_M = M;
     std::array<NVector<T, N>*, N> pRows = FOLD(Ns, N, (std::array<NVector<T, N>*, N> { &cp_M[Ns]... }));
     T sgn = T(1.0);
 
     for(size_t j = 0; j < N - 1; j++) {
-        for(size_t i = j; i < N; i++) {
-            if((*pRows[i])[j] != T(0.0)) {
-                std::swap(pRows[i], pRows[j]), sgn *= T(-1.0);
-                break;
-            }
-        }
+        // Partial pivoting: the largest remaining entry of column j keeps the eliminations well-conditioned
+        size_t p = j;
+        for(size_t i = j + 1; i < N; i++)
+            if(Abs((*pRows[i])[j]) > Abs((*pRows[p])[j]))
+                p = i;
+
+        if(p != j)
+            std::swap(pRows[p], pRows[j]), sgn *= T(-1.0);
 
         if((*pRows[j])[j] == T(0.0))
             return T(0.0);
 
-        for(size_t i = j + 1; i < N; i++)
+        auto eliminate_row = [&](size_t i) {
             *pRows[i] -= (*pRows[j]) * ((*pRows[i])[j])/((*pRows[j])[j]);
+        };
+
+        if constexpr(N >= __det_parallel_threshold) {
+            if(!std::is_constant_evaluated()) {
+                ParallelFor(j + 1, N, eliminate_row, std::max<size_t>(1, 16384 / N));
+                continue;
+            }
+        }
+
+        for(size_t i = j + 1; i < N; i++)
+            eliminate_row(i);
     }
 
     return sgn * FOLD(Ns, N, (*pRows[Ns])[Ns] * ...);
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+
+#include "uint128_t.hpp"
+
+namespace Modular {
+    /**
+     * @brief A 64-bit modulus with the residue arithmetic it supports. Values are kept in a context-specific
+     * domain: `Encode` maps a plain integer into it, `Decode` maps back, and `Mul` multiplies two encoded values.
+     */
+    template <class C>
+    concept Context = requires(const C& ctx, uint64_t x) {
+        { ctx.Modulus() } -> std::same_as<uint64_t>;
+        { ctx.Encode(x) } -> std::same_as<uint64_t>;
+        { ctx.Decode(x) } -> std::same_as<uint64_t>;
+        { ctx.One() } -> std::same_as<uint64_t>;
+        { ctx.Mul(x, x) } -> std::same_as<uint64_t>;
+        { ctx.MulPlain(x, x) } -> std::same_as<uint64_t>;
+    };
+
+    constexpr uint64_t __add_mod(uint64_t a, uint64_t b, uint64_t n) noexcept {
+        const uint64_t s = a + b;
+        return (s < a || s >= n) ? s - n : s;
+    }
+
+    constexpr uint64_t __sub_mod(uint64_t a, uint64_t b, uint64_t n) noexcept {
+        return a >= b ? a - b : a - b + n;
+    }
+
+    /**
+     * @brief Montgomery arithmetic modulo an odd 64-bit `n` with R = 2^64. Encoded values are x * R mod n,
+     * and a multiplication costs two 64x64 products and no division.
+     */
+    class MontgomeryContext {
+    public:
+        constexpr MontgomeryContext(uint64_t n) : _N(n) {
+            if(n % 2 == 0)
+                throw std::logic_error("Attempted to create a Montgomery context for an even modulus");
+
+            // Newton's iteration for n^-1 mod 2^64; n * n == 1 mod 8 gives the first 3 bits
+            uint64_t inv = n;
+            for(int i = 0; i < 5; i++)
+                inv *= 2 - n * inv;
+            _NInv = inv;
+
+            _R1 = (0 - n) % n;
+            _R2 = uint64_t(__umul128(_R1, _R1) % uint128_t(n));
+        }
+
+        constexpr uint64_t Modulus() const noexcept { return _N; }
+        constexpr uint64_t One() const noexcept { return _R1; }
+
+        /// @brief Montgomery reduction: t * R^-1 mod n for t < n * 2^64.
+        constexpr uint64_t Reduce(uint128_t t) const noexcept {
+            const uint64_t m = t.Lo() * _NInv;
+            const uint64_t mn_hi = __umul128(m, _N).Hi();
+            return t.Hi() >= mn_hi ? t.Hi() - mn_hi : t.Hi() - mn_hi + _N;
+        }
+
+        /// @brief x R mod n for any x; x * R^2 mod n is below n * 2^64 already, so no division is needed.
+        constexpr uint64_t Encode(uint64_t x) const noexcept { return Reduce(__umul128(x, _R2)); }
+        constexpr uint64_t Decode(uint64_t x) const noexcept { return Reduce(uint128_t(x)); }
+
+        constexpr uint64_t Mul(uint64_t a, uint64_t b) const noexcept { return Reduce(__umul128(a, b)); }
+        constexpr uint64_t Add(uint64_t a, uint64_t b) const noexcept { return __add_mod(a, b, _N); }
+        constexpr uint64_t Sub(uint64_t a, uint64_t b) const noexcept { return __sub_mod(a, b, _N); }
+
+        /// @brief a * b mod n for plain (unencoded) a, b < n; the R factors of one Encode and one Reduce cancel.
+        constexpr uint64_t MulPlain(uint64_t a, uint64_t b) const noexcept { return Mul(Encode(a), b); }
+
+    private:
+        uint64_t _N, _NInv, _R1, _R2;
+    };
+
+    /**
+     * @brief Barrett arithmetic modulo any 64-bit `n` > 0. Values are kept plain and a product is reduced
+     * with a precomputed floor((2^128 - 1) / n) instead of a division.
+     */
+    class BarrettContext {
+    public:
+        constexpr BarrettContext(uint64_t n) : _N(n) {
+            if(n == 0)
+                throw std::logic_error("Attempted to create a Barrett context for a zero modulus");
+
+            _Mu = uint128_t(~uint64_t(0), ~uint64_t(0)) / uint128_t(n);
+        }
+
+        constexpr uint64_t Modulus() const noexcept { return _N; }
+        constexpr uint64_t One() const noexcept { return _N == 1 ? 0 : 1; }
+
+        /// @brief x mod n for any 128-bit x.
+        constexpr uint64_t Reduce(uint128_t x) const noexcept {
+            // q = floor(x * mu / 2^128) underestimates floor(x / n) by at most 2
+            const uint64_t x1 = x.Hi(), x0 = x.Lo(), m1 = _Mu.Hi(), m0 = _Mu.Lo();
+
+            uint128_t mid = uint128_t(__umul128(x0, m0).Hi());
+            const uint128_t p1 = __umul128(x1, m0), p2 = __umul128(x0, m1);
+            uint64_t carry = 0;
+            mid += p1;
+            carry += mid < p1;
+            mid += p2;
+            carry += mid < p2;
+
+            uint128_t q = __umul128(x1, m1);
+            q += uint128_t(carry, mid.Hi());
+
+            uint128_t r = x;
+            uint128_t qn = q;
+            qn *= uint128_t(_N);
+            r -= qn;
+            while(r >= uint128_t(_N))
+                r -= uint128_t(_N);
+
+            return r.Lo();
+        }
+
+        constexpr uint64_t Encode(uint64_t x) const noexcept { return x < _N ? x : Reduce(uint128_t(x)); }
+        constexpr uint64_t Decode(uint64_t x) const noexcept { return x; }
+
+        constexpr uint64_t Mul(uint64_t a, uint64_t b) const noexcept { return Reduce(__umul128(a, b)); }
+        constexpr uint64_t Add(uint64_t a, uint64_t b) const noexcept { return __add_mod(a, b, _N); }
+        constexpr uint64_t Sub(uint64_t a, uint64_t b) const noexcept { return __sub_mod(a, b, _N); }
+
+        constexpr uint64_t MulPlain(uint64_t a, uint64_t b) const noexcept { return Mul(a, b); }
+
+    private:
+        uint64_t _N;
+        uint128_t _Mu;
+    };
+
+    /// @brief base^exp in the context's encoded domain, by binary exponentiation.
+    template <Context C>
+    constexpr uint64_t PowEncoded(const C& ctx, uint64_t base, uint64_t exp) noexcept {
+        uint64_t res = ctx.One();
+        while(exp > 0) {
+            if(exp & 1)
+                res = ctx.Mul(res, base);
+            base = ctx.Mul(base, base);
+            exp >>= 1;
+        }
+        return res;
+    }
+
+    /// @brief base^exp mod n for a plain base.
+    template <Context C>
+    constexpr uint64_t Pow(const C& ctx, uint64_t base, uint64_t exp) noexcept {
+        return ctx.Decode(PowEncoded(ctx, ctx.Encode(base), exp));
+    }
+
+    /// @brief out[i] = a[i] * b[i] mod n for plain a[i], b[i] < n, reusing one context for the whole batch.
+    template <Context C>
+    constexpr void MulBatch(const C& ctx, std::span<const uint64_t> a, std::span<const uint64_t> b, std::span<uint64_t> out) {
+        if(a.size() != b.size() || out.size() != a.size())
+            throw std::logic_error("Attempted to multiply batches of different lengths");
+
+        // Four independent chains per iteration keep the multiplier busy
+        size_t i = 0;
+        for(; i + 4 <= a.size(); i += 4) {
+            const uint64_t r0 = ctx.MulPlain(a[i], b[i]), r1 = ctx.MulPlain(a[i + 1], b[i + 1]);
+            const uint64_t r2 = ctx.MulPlain(a[i + 2], b[i + 2]), r3 = ctx.MulPlain(a[i + 3], b[i + 3]);
+            out[i] = r0, out[i + 1] = r1, out[i + 2] = r2, out[i + 3] = r3;
+        }
+        for(; i < a.size(); i++)
+            out[i] = ctx.MulPlain(a[i], b[i]);
+    }
+
+    /// @brief Deterministic Miller-Rabin for every 64-bit input (Sinclair's seven bases).
+    constexpr bool IsPrime(uint64_t n) noexcept {
+        if(n < 2)
+            return false;
+        for(uint64_t p : { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 })
+            if(n % p == 0)
+                return n == p;
+        if(n < 37 * 37)
+            return true;
+
+        const MontgomeryContext ctx(n);
+        const uint64_t one = ctx.One(), minus_one = n - one;
+        const int s = std::countr_zero(n - 1);
+        const uint64_t d = (n - 1) >> s;
+
+        for(uint64_t a : { 2ull, 325ull, 9375ull, 28178ull, 450775ull, 9780504ull, 1795265022ull }) {
+            if(a % n == 0)
+                continue;
+
+            uint64_t x = PowEncoded(ctx, ctx.Encode(a), d);
+            if(x == one || x == minus_one)
+                continue;
+
+            bool composite = true;
+            for(int r = 1; r < s && composite; r++) {
+                x = ctx.Mul(x, x);
+                composite = x != minus_one;
+            }
+            if(composite)
+                return false;
+        }
+
+        return true;
+    }
+};
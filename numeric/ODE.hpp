@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "Matrices.hpp"
+#include "Pack.hpp"
+#include "other/Parallel.hpp"
+
+namespace Integrator::ODE {
+    /// @brief A right-hand side y' = f(t, y) for a state of `N` components of type `S`.
+    template <class F, class T, size_t N, class S = T>
+    concept System = std::invocable<F&, const T&, const NVector<S, N>&>
+        && std::convertible_to<std::invoke_result_t<F&, const T&, const NVector<S, N>&>, NVector<S, N>>;
+
+    /// @brief An acceleration q'' = a(q) of a separable Hamiltonian system with unit mass.
+    template <class F, class T, size_t N>
+    concept Acceleration = std::invocable<F&, const NVector<T, N>&>
+        && std::convertible_to<std::invoke_result_t<F&, const NVector<T, N>&>, NVector<T, N>>;
+
+    /**
+     * @brief The classical fixed-step fourth-order Runge-Kutta method. Stage buffers live in the stepper,
+     * so stepping never allocates.
+     * @tparam S the state scalar, which may be a `Pack` to advance several systems in lockstep
+     */
+    template <class T, size_t N, class S = T>
+    class RK4 {
+    public:
+        template <System<T, N, S> F>
+        constexpr void Step(F& f, T& t, NVector<S, N>& y, const T& h) {
+            const S h2 = S(h * T(0.5)), h6 = S(h / T(6));
+
+            _K1 = f(t, y);
+            for(size_t i = 0; i < N; i++) _Tmp[i] = y[i] + h2 * _K1[i];
+            _K2 = f(t + h * T(0.5), _Tmp);
+            for(size_t i = 0; i < N; i++) _Tmp[i] = y[i] + h2 * _K2[i];
+            _K3 = f(t + h * T(0.5), _Tmp);
+            for(size_t i = 0; i < N; i++) _Tmp[i] = y[i] + S(h) * _K3[i];
+            _K4 = f(t + h, _Tmp);
+
+            for(size_t i = 0; i < N; i++)
+                y[i] += h6 * (_K1[i] + S(2) * (_K2[i] + _K3[i]) + _K4[i]);
+            t += h;
+        }
+
+        template <System<T, N, S> F>
+        constexpr void Integrate(F& f, T& t, NVector<S, N>& y, const T& h, size_t steps) {
+            for(size_t n = 0; n < steps; n++)
+                Step(f, t, y, h);
+        }
+
+    private:
+        NVector<S, N> _K1, _K2, _K3, _K4, _Tmp;
+    };
+
+    /**
+     * @brief The adaptive Dormand-Prince 5(4) method with first-same-as-last reuse and a fourth-order
+     * dense output over the last accepted step.
+     */
+    template <class T, size_t N>
+    class DormandPrince45 {
+    public:
+        constexpr DormandPrince45(const T& abs_tol = T(1e-8), const T& rel_tol = T(1e-8)) noexcept : AbsTol(abs_tol), RelTol(rel_tol) {}
+
+        /**
+         * @brief Attempt one step of size `h` from `(t, y)`. On acceptance, `t` and `y` are advanced and
+         * `DenseOutput` covers the step. Either way `h` is replaced by the suggested next step size.
+         * @return whether the step was accepted
+         */
+        template <System<T, N> F>
+        bool Step(F& f, T& t, NVector<T, N>& y, T& h) {
+            using std::abs, std::pow, std::sqrt;
+
+            // The last stage of the previous accepted step is the first stage of this one
+            if(!_HasFsal || t != _T1 || !__same_state(y, _Y1))
+                _K[0] = f(t, y);
+
+            __stage(f, t, y, h, 1, { T(1) / T(5) }, T(1) / T(5));
+            __stage(f, t, y, h, 2, { T(3) / T(40), T(9) / T(40) }, T(3) / T(10));
+            __stage(f, t, y, h, 3, { T(44) / T(45), T(-56) / T(15), T(32) / T(9) }, T(4) / T(5));
+            __stage(f, t, y, h, 4, { T(19372) / T(6561), T(-25360) / T(2187), T(64448) / T(6561), T(-212) / T(729) }, T(8) / T(9));
+            __stage(f, t, y, h, 5, { T(9017) / T(3168), T(-355) / T(33), T(46732) / T(5247), T(49) / T(176), T(-5103) / T(18656) }, T(1));
+
+            for(size_t i = 0; i < N; i++)
+                _Ynew[i] = y[i] + h * (T(35) / T(384) * _K[0][i] + T(500) / T(1113) * _K[2][i] + T(125) / T(192) * _K[3][i]
+                    - T(2187) / T(6784) * _K[4][i] + T(11) / T(84) * _K[5][i]);
+            _K[6] = f(t + h, _Ynew);
+
+            T err = T(0);
+            for(size_t i = 0; i < N; i++) {
+                const T e = h * (T(71) / T(57600) * _K[0][i] - T(71) / T(16695) * _K[2][i] + T(71) / T(1920) * _K[3][i]
+                    - T(17253) / T(339200) * _K[4][i] + T(22) / T(525) * _K[5][i] - T(1) / T(40) * _K[6][i]);
+                const T sc = AbsTol + RelTol * std::max(abs(y[i]), abs(_Ynew[i]));
+                err += (e / sc) * (e / sc);
+            }
+            err = sqrt(err / T(N));
+
+            const T fac = err == T(0) ? T(MaxGrowth) : std::clamp(T(0.9) * pow(err, T(-0.2)), T(MinShrink), T(MaxGrowth));
+            if(err > T(1)) {
+                h *= std::min(fac, T(1));
+                return false;
+            }
+
+            // Hairer's continuous extension for dopri5
+            for(size_t i = 0; i < N; i++) {
+                const T ydiff = _Ynew[i] - y[i];
+                const T bspl = h * _K[0][i] - ydiff;
+                _Dense[0][i] = y[i];
+                _Dense[1][i] = ydiff;
+                _Dense[2][i] = bspl;
+                _Dense[3][i] = ydiff - h * _K[6][i] - bspl;
+                _Dense[4][i] = h * (T(-12715105075.0) / T(11282082432.0) * _K[0][i] + T(87487479700.0) / T(32700410799.0) * _K[2][i]
+                    - T(10690763975.0) / T(1880347072.0) * _K[3][i] + T(701980252875.0) / T(199316789632.0) * _K[4][i]
+                    - T(1453857185.0) / T(822651844.0) * _K[5][i] + T(69997945.0) / T(29380423.0) * _K[6][i]);
+            }
+
+            _T0 = t, _H = h;
+            t += h, y = _Ynew;
+            _T1 = t, _Y1 = y, _K[0] = _K[6], _HasFsal = true;
+            h *= fac;
+            return true;
+        }
+
+        /// @brief Advance `(t, y)` to exactly `t_end`, starting from the step size `h` and leaving the next suggested one in it.
+        template <System<T, N> F>
+        void Integrate(F& f, T& t, NVector<T, N>& y, const T& t_end, T& h, size_t max_steps = 1000000) {
+            for(size_t n = 0; t < t_end; n++) {
+                if(n >= max_steps)
+                    throw std::runtime_error("Attempted to integrate with more steps than allowed");
+
+                // Clamp the last step onto t_end without letting it shrink the suggestion for later calls
+                T step = std::min(h, t_end - t);
+                const bool clamped = step < h;
+                const bool accepted = Step(f, t, y, step);
+                if(accepted && clamped) {
+                    t = t_end;
+                    h = std::max(h, step);
+                }
+                else h = step;
+            }
+        }
+
+        /// @brief Evaluate the dense output at `t` within the last accepted step.
+        constexpr NVector<T, N> DenseOutput(const T& t) const {
+            const T theta = (t - _T0) / _H, theta1 = T(1) - theta;
+            NVector<T, N> res;
+            for(size_t i = 0; i < N; i++)
+                res[i] = _Dense[0][i] + theta * (_Dense[1][i] + theta1 * (_Dense[2][i] + theta * (_Dense[3][i] + theta1 * _Dense[4][i])));
+            return res;
+        }
+
+        /// @brief Forget the cached first stage, e.g. after the right-hand side has changed.
+        constexpr void Reset() noexcept { _HasFsal = false; }
+
+        T AbsTol, RelTol;
+        static constexpr double MinShrink = 0.2, MaxGrowth = 10.0;
+
+    private:
+        template <System<T, N> F, size_t M>
+        void __stage(F& f, const T& t, const NVector<T, N>& y, const T& h, size_t s, const T (&a)[M], const T& c) {
+            for(size_t i = 0; i < N; i++) {
+                T acc = T(0);
+                for(size_t j = 0; j < M; j++)
+                    acc += a[j] * _K[j][i];
+                _Ynew[i] = y[i] + h * acc;
+            }
+            _K[s] = f(t + c * h, _Ynew);
+        }
+
+        static constexpr bool __same_state(const NVector<T, N>& a, const NVector<T, N>& b) {
+            for(size_t i = 0; i < N; i++)
+                if(a[i] != b[i]) return false;
+            return true;
+        }
+
+        std::array<NVector<T, N>, 7> _K;
+        std::array<NVector<T, N>, 5> _Dense;
+        NVector<T, N> _Ynew, _Y1;
+        T _T0 = T(0), _T1 = T(0), _H = T(0);
+        bool _HasFsal = false;
+    };
+
+    /**
+     * @brief Second-order symplectic velocity Verlet for q'' = a(q). The acceleration at the end of a step is
+     * kept for the start of the next one, so each step costs a single evaluation of `a`.
+     */
+    template <class T, size_t N>
+    class VelocityVerlet {
+    public:
+        template <Acceleration<T, N> F>
+        void Step(F& a, NVector<T, N>& q, NVector<T, N>& v, const T& h) {
+            if(!_HasAccel || !__same_position(q))
+                _Accel = a(q);
+
+            for(size_t i = 0; i < N; i++) {
+                v[i] += T(0.5) * h * _Accel[i];
+                q[i] += h * v[i];
+            }
+            _Accel = a(q);
+            for(size_t i = 0; i < N; i++)
+                v[i] += T(0.5) * h * _Accel[i];
+
+            _Q = q, _HasAccel = true;
+        }
+
+        constexpr void Reset() noexcept { _HasAccel = false; }
+
+    private:
+        constexpr bool __same_position(const NVector<T, N>& q) const {
+            for(size_t i = 0; i < N; i++)
+                if(q[i] != _Q[i]) return false;
+            return true;
+        }
+
+        NVector<T, N> _Accel, _Q;
+        bool _HasAccel = false;
+    };
+
+    /// @brief Yoshida's fourth-order symplectic composition of three velocity Verlet substeps.
+    template <class T, size_t N>
+    class Yoshida4 {
+    public:
+        template <Acceleration<T, N> F>
+        void Step(F& a, NVector<T, N>& q, NVector<T, N>& v, const T& h) {
+            using std::cbrt;
+            static const T w1 = T(1) / (T(2) - cbrt(T(2)));
+            static const T w0 = -cbrt(T(2)) * w1;
+
+            _Verlet.Step(a, q, v, w1 * h);
+            _Verlet.Step(a, q, v, w0 * h);
+            _Verlet.Step(a, q, v, w1 * h);
+        }
+
+        constexpr void Reset() noexcept { _Verlet.Reset(); }
+
+    private:
+        VelocityVerlet<T, N> _Verlet;
+    };
+
+    /**
+     * @brief Many independent initial conditions of the same system, stored as SoA batches of `W` lanes and
+     * advanced in lockstep with `RK4<T, N, Pack<T, W>>`. Batches are distributed across cores.
+     * @note The right-hand side is invoked with `NVector<Pack<T, W>, N>` states, so it must be written
+     * generically over its scalar type and must not branch on the state.
+     */
+    template <class T, size_t N, size_t W = 8>
+    class Ensemble {
+    public:
+        using Lane = Pack<T, W>;
+
+        Ensemble(std::span<const NVector<T, N>> initial) : _Count(initial.size()), _Batches((initial.size() + W - 1) / W) {
+            for(size_t k = 0; k < _Batches.size() * W; k++)
+                Set(k, initial[std::min(k, _Count - 1)]);  // Padding lanes replicate the last system
+        }
+
+        constexpr size_t Size() const noexcept { return _Count; }
+
+        NVector<T, N> operator[](size_t k) const {
+            NVector<T, N> res;
+            for(size_t i = 0; i < N; i++)
+                res[i] = _Batches[k / W][i][k % W];
+            return res;
+        }
+
+        void Set(size_t k, const NVector<T, N>& y) {
+            for(size_t i = 0; i < N; i++)
+                _Batches[k / W][i][k % W] = y[i];
+        }
+
+        /// @brief Advance every system by `steps` RK4 steps of size `h` from `t`.
+        template <System<T, N, Lane> F>
+        void Advance(F f, const T& t, const T& h, size_t steps, bool parallel = true) {
+            auto advance = [&](size_t b) {
+                RK4<T, N, Lane> stepper;
+                T tb = t;
+                stepper.Integrate(f, tb, _Batches[b], h, steps);
+            };
+
+            if(parallel)
+                ParallelFor(0, _Batches.size(), advance);
+            else for(size_t b = 0; b < _Batches.size(); b++)
+                advance(b);
+        }
+
+    private:
+        size_t _Count;
+        std::vector<NVector<Lane, N>> _Batches;
+    };
+};
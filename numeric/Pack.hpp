@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+
+/**
+ * @brief A fixed-width bundle of `W` independent lanes of `T` with element-wise arithmetic, used to run
+ * scalar-looking code over several data sets at once (SoA batches).
+ * @note The lanes are contiguous and aligned and every operation is a fixed-length loop, so the compiler
+ * maps each one onto vector instructions. Branching on a `Pack` is not supported.
+ */
+template <class T, size_t W>
+class Pack {
+public:
+    constexpr Pack() noexcept : Lanes({}) {}
+    constexpr Pack(const T& val) noexcept { Lanes.fill(val); }
+    constexpr Pack(const std::array<T, W>& lanes) noexcept : Lanes(lanes) {}
+
+    constexpr const T& operator[](size_t i) const { return Lanes[i]; }
+    constexpr T& operator[](size_t i) { return Lanes[i]; }
+
+    constexpr Pack& operator+=(const Pack& b) noexcept { for(size_t i = 0; i < W; i++) Lanes[i] += b.Lanes[i]; return *this; }
+    constexpr Pack& operator-=(const Pack& b) noexcept { for(size_t i = 0; i < W; i++) Lanes[i] -= b.Lanes[i]; return *this; }
+    constexpr Pack& operator*=(const Pack& b) noexcept { for(size_t i = 0; i < W; i++) Lanes[i] *= b.Lanes[i]; return *this; }
+    constexpr Pack& operator/=(const Pack& b) noexcept { for(size_t i = 0; i < W; i++) Lanes[i] /= b.Lanes[i]; return *this; }
+
+    constexpr Pack& operator+=(const T& b) noexcept { for(size_t i = 0; i < W; i++) Lanes[i] += b; return *this; }
+    constexpr Pack& operator-=(const T& b) noexcept { for(size_t i = 0; i < W; i++) Lanes[i] -= b; return *this; }
+    constexpr Pack& operator*=(const T& b) noexcept { for(size_t i = 0; i < W; i++) Lanes[i] *= b; return *this; }
+    constexpr Pack& operator/=(const T& b) noexcept { for(size_t i = 0; i < W; i++) Lanes[i] /= b; return *this; }
+
+    friend constexpr Pack operator+(const Pack& a) noexcept { return a; }
+    friend constexpr Pack operator-(const Pack& a) noexcept { Pack res; for(size_t i = 0; i < W; i++) res.Lanes[i] = -a.Lanes[i]; return res; }
+
+    friend constexpr Pack operator+(const Pack& a, const Pack& b) noexcept { Pack res = a; return res += b; }
+    friend constexpr Pack operator-(const Pack& a, const Pack& b) noexcept { Pack res = a; return res -= b; }
+    friend constexpr Pack operator*(const Pack& a, const Pack& b) noexcept { Pack res = a; return res *= b; }
+    friend constexpr Pack operator/(const Pack& a, const Pack& b) noexcept { Pack res = a; return res /= b; }
+
+    friend constexpr Pack operator+(const Pack& a, const T& b) noexcept { Pack res = a; return res += b; }
+    friend constexpr Pack operator-(const Pack& a, const T& b) noexcept { Pack res = a; return res -= b; }
+    friend constexpr Pack operator*(const Pack& a, const T& b) noexcept { Pack res = a; return res *= b; }
+    friend constexpr Pack operator/(const Pack& a, const T& b) noexcept { Pack res = a; return res /= b; }
+
+    friend constexpr Pack operator+(const T& a, const Pack& b) noexcept { return b + a; }
+    friend constexpr Pack operator-(const T& a, const Pack& b) noexcept { return Pack(a) -= b; }
+    friend constexpr Pack operator*(const T& a, const Pack& b) noexcept { return b * a; }
+    friend constexpr Pack operator/(const T& a, const Pack& b) noexcept { return Pack(a) /= b; }
+
+    alignas(std::bit_floor(sizeof(T) * W) >= 64 ? 64 : std::bit_floor(sizeof(T) * W)) std::array<T, W> Lanes;
+};
+
+#define __PACK_UNARY_FUNCTION(name) \
+    template <class T, size_t W> \
+    constexpr Pack<T, W> name(const Pack<T, W>& a) { \
+        using std::name; \
+        Pack<T, W> res; \
+        for(size_t i = 0; i < W; i++) res.Lanes[i] = name(a.Lanes[i]); \
+        return res; \
+    }
+
+__PACK_UNARY_FUNCTION(abs)
+__PACK_UNARY_FUNCTION(sqrt)
+__PACK_UNARY_FUNCTION(exp)
+__PACK_UNARY_FUNCTION(log)
+__PACK_UNARY_FUNCTION(sin)
+__PACK_UNARY_FUNCTION(cos)
+__PACK_UNARY_FUNCTION(tan)
+__PACK_UNARY_FUNCTION(atan)
+__PACK_UNARY_FUNCTION(floor)
+__PACK_UNARY_FUNCTION(exp2)
+
+#undef __PACK_UNARY_FUNCTION
+
+template <class T, size_t W>
+constexpr Pack<T, W> pow(const Pack<T, W>& a, const T& p) {
+    using std::pow;
+    Pack<T, W> res;
+    for(size_t i = 0; i < W; i++) res.Lanes[i] = pow(a.Lanes[i], p);
+    return res;
+}
+
+template <class T, size_t W>
+constexpr Pack<T, W> fma(const Pack<T, W>& a, const Pack<T, W>& b, const Pack<T, W>& c) {
+    using std::fma;
+    Pack<T, W> res;
+    for(size_t i = 0; i < W; i++) res.Lanes[i] = fma(a.Lanes[i], b.Lanes[i], c.Lanes[i]);
+    return res;
+}
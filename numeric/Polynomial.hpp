@@ -2,39 +2,100 @@
 
 #include <algorithm>
 #include <array>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
-template <class T> class Polynomial;
-template <class T> constexpr Polynomial<T>& __polynomial_add(Polynomial<T>&, const Polynomial<T>&);
-template <class T> constexpr Polynomial<T>& __polynomial_add(Polynomial<T>&, const T&);
-template <class T> constexpr Polynomial<T>& __polynomial_sub(Polynomial<T>&, const Polynomial<T>&);
-template <class T> constexpr Polynomial<T>& __polynomial_sub(Polynomial<T>&, const T&);
-template <class T> constexpr Polynomial<T>& __polynomial_mul(Polynomial<T>&, const Polynomial<T>&);
-template <class T> constexpr Polynomial<T>& __polynomial_mul(Polynomial<T>&, const T&);
-template <class T> constexpr std::pair<Polynomial<T>, Polynomial<T>> __polynomial_div(const Polynomial<T>&, const Polynomial<T>&);
+#include "other/Instrument.hpp"
+#include "other/Parallel.hpp"
 
+template <class T, class A> class Polynomial;
+template <class T, class A> constexpr Polynomial<T, A>& __polynomial_add(Polynomial<T, A>&, const Polynomial<T, A>&);
+template <class T, class A> constexpr Polynomial<T, A>& __polynomial_add(Polynomial<T, A>&, const T&);
+template <class T, class A> constexpr Polynomial<T, A>& __polynomial_sub(Polynomial<T, A>&, const Polynomial<T, A>&);
+template <class T, class A> constexpr Polynomial<T, A>& __polynomial_sub(Polynomial<T, A>&, const T&);
+template <class T, class A> constexpr Polynomial<T, A>& __polynomial_mul(Polynomial<T, A>&, const Polynomial<T, A>&);
+template <class T, class A> constexpr Polynomial<T, A>& __polynomial_mul(Polynomial<T, A>&, const T&);
+template <class T, class A> constexpr std::pair<Polynomial<T, A>, Polynomial<T, A>> __polynomial_div(const Polynomial<T, A>&, const Polynomial<T, A>&);
+
+// Horner's scheme over coefficients in increasing degree
+template <class T, class V>
+constexpr auto __horner(std::span<const T> coefficients, const V& x) -> decltype(std::declval<T>() * std::declval<V>()) {
+    using ret_type = decltype(std::declval<T>() * std::declval<V>());
+
+    ret_type res = ret_type(0);
+    for(auto it = coefficients.rbegin(); it != coefficients.rend(); it++)
+        res = res * x + *it;
+
+    return res;
+}
+
+// Horner's scheme at n points from x into y, in blocks of grain points spread over pool
+template <class T, class X, class Y>
+void __horner_batch(std::span<const T> coefficients, const X* x, Y* y, size_t n, ThreadPool& pool, size_t grain) {
+    // Horner runs on local copies of a fixed number of points, which nothing else aliases and whose trip count
+    // is known, so the inner loop vectorises; a short last block is padded with the points already there
+    auto evaluate_block = [&](size_t first, size_t last) {
+        constexpr size_t block = 64;
+        std::array<X, block> xb {};
+        std::array<Y, block> acc;
+        for(size_t lo = first; lo < last; lo += block) {
+            const size_t m = std::min(block, last - lo);
+            std::copy_n(x + lo, m, xb.begin());
+            acc.fill(Y(0));
+            for(auto it = coefficients.rbegin(); it != coefficients.rend(); it++) {
+                const T c = *it;
+                for(size_t i = 0; i < block; i++)
+                    acc[i] = acc[i] * xb[i] + c;
+            }
+            std::copy_n(acc.begin(), m, y + lo);
+        }
+    };
+
+    grain = std::max<size_t>(grain, 1);
+    ParallelFor(pool, 0, (n + grain - 1) / grain, [&](size_t k) {
+        evaluate_block(k * grain, std::min(n, (k + 1) * grain));
+    });
+}
 
 /** 
  * @brief A template class for univariate polynomial over the given type.
  * @tparam T the type of coefficients 
+ * @tparam A the allocator of the coefficients. Results of arithmetic are allocated like their left operand,
+ * so polynomials built on a std::pmr resource stay on it.
  */
-template <class T>
+template <class T, class A = std::allocator<T>>
 class Polynomial {
 public:
+    using allocator_type = A;
+
     constexpr Polynomial() noexcept = default;
-    constexpr Polynomial(const T& val) : Coefficients({ val }) {}
-    constexpr Polynomial(std::initializer_list<T> lst) {
-        Coefficients = std::vector<T>(lst);
+    constexpr explicit Polynomial(const A& alloc) noexcept : Coefficients(alloc) {}
+    constexpr Polynomial(const T& val, const A& alloc = A()) : Coefficients({ val }, alloc) {}
+    constexpr Polynomial(std::initializer_list<T> lst, const A& alloc = A()) : Coefficients(lst, alloc) {
         _normalize();
     }
 
-    constexpr Polynomial<T> GetFormalDerivative() const {
+    constexpr Polynomial(const Polynomial&) = default;
+    constexpr Polynomial(Polynomial&&) noexcept = default;
+    constexpr Polynomial(const Polynomial& other, const A& alloc) : Coefficients(other.Coefficients, alloc) {}
+    constexpr Polynomial& operator=(const Polynomial&) = default;
+    constexpr Polynomial& operator=(Polynomial&&) = default;
+
+    constexpr A GetAllocator() const noexcept {
+        return Coefficients.get_allocator();
+    }
+
+    constexpr Polynomial<T, A> GetFormalDerivative() const {
         if(Coefficients.size() <= 1)
-            return {T(0)};
+            return Polynomial<T, A>(T(0), GetAllocator());
         
-        Polynomial<T> res;
-        res.Coefficients = std::vector<T>(Coefficients.size() - 1);
+        Polynomial<T, A> res(GetAllocator());
+        res.Coefficients.resize(Coefficients.size() - 1);
         for(size_t i = 0; i < Coefficients.size() - 1; i++)
             res.Coefficients[i] = Coefficients[i+1] * (i+1);
         
@@ -42,36 +103,44 @@ public:
     }
 
     /// @brief Evaluate the polynomial by substituting the argument into the indeterminate.
+    /// @note Uses Horner's scheme, so derivative-carrying arguments such as `Dual` propagate exactly.
     template <class V>
     constexpr auto operator()(const V& x) const -> decltype(std::declval<T>() * std::declval<V>()) {
-        using ret_type = decltype(std::declval<T>() * std::declval<V>());
+        __INSTRUMENT_OP("Polynomial::operator()");
+        __INSTRUMENT_FLOPS(2 * Degree());
 
-        if(x == V(0.0))
-            return Coefficients[0] * V(1.0);
-
-        V xpow = V(1.0);
-        ret_type res = ret_type(0.0);
-        for(auto& a : Coefficients) {
-            res += a * xpow;
-            xpow *= x;
-        }
+        return __horner(std::span<const T>(Coefficients), x);
+    }
 
-        return res;
+    /**
+     * @brief Evaluate the polynomial at every point of xs into out, splitting long inputs across pool.
+     * @note Horner's scheme runs over a block of points per coefficient, which vectorises for arithmetic types;
+     * each out[i] is computed in the same order as (*this)(xs[i]).
+     */
+    template <std::ranges::contiguous_range X, std::ranges::contiguous_range R>
+    void EvaluateBatch(const X& xs, R&& out, ThreadPool& pool = DefaultThreadPool(), size_t grain = 4096) const {
+        const size_t n = std::ranges::size(xs);
+        if(std::ranges::size(out) != n)
+            throw std::logic_error("Attempted to evaluate a polynomial into an output of different length");
+
+        __INSTRUMENT_OP("Polynomial::EvaluateBatch");
+        __INSTRUMENT_FLOPS(2 * Degree() * n);
+        __horner_batch(std::span<const T>(Coefficients), std::ranges::data(xs), std::ranges::data(out), n, pool, grain);
     }
 
     constexpr size_t Degree() const {
         return Coefficients.size() > 0 ? Coefficients.size() - 1 : 0;
     }
 
-    std::vector<T> Coefficients;
+    std::vector<T, A> Coefficients;
 
-    friend constexpr Polynomial<T>& __polynomial_add<>(Polynomial<T>&, const Polynomial<T>&);
-    friend constexpr Polynomial<T>& __polynomial_add<>(Polynomial<T>&, const T&);
-    friend constexpr Polynomial<T>& __polynomial_sub<>(Polynomial<T>&, const Polynomial<T>&);
-    friend constexpr Polynomial<T>& __polynomial_sub<>(Polynomial<T>&, const T&);
-    friend constexpr Polynomial<T>& __polynomial_mul<>(Polynomial<T>&, const Polynomial<T>&);
-    friend constexpr Polynomial<T>& __polynomial_mul<>(Polynomial<T>&, const T&);
-    friend constexpr std::pair<Polynomial<T>, Polynomial<T>> __polynomial_div<>(const Polynomial<T>&, const Polynomial<T>&);
+    friend constexpr Polynomial<T, A>& __polynomial_add<>(Polynomial<T, A>&, const Polynomial<T, A>&);
+    friend constexpr Polynomial<T, A>& __polynomial_add<>(Polynomial<T, A>&, const T&);
+    friend constexpr Polynomial<T, A>& __polynomial_sub<>(Polynomial<T, A>&, const Polynomial<T, A>&);
+    friend constexpr Polynomial<T, A>& __polynomial_sub<>(Polynomial<T, A>&, const T&);
+    friend constexpr Polynomial<T, A>& __polynomial_mul<>(Polynomial<T, A>&, const Polynomial<T, A>&);
+    friend constexpr Polynomial<T, A>& __polynomial_mul<>(Polynomial<T, A>&, const T&);
+    friend constexpr std::pair<Polynomial<T, A>, Polynomial<T, A>> __polynomial_div<>(const Polynomial<T, A>&, const Polynomial<T, A>&);
 
 private:
     constexpr void _normalize() {
@@ -82,6 +151,60 @@ private:
     }
 };
 
+namespace pmr {
+    /// @brief A polynomial whose coefficients come from a std::pmr::memory_resource, such as a BumpArena.
+    template <class T>
+    using Polynomial = ::Polynomial<T, std::pmr::polymorphic_allocator<T>>;
+};
+
+/**
+ * @brief A non-owning polynomial over coefficients stored elsewhere, in increasing degree, such as those of a
+ * Polynomial or of a mapped table file (see numeric/Tables.hpp). It evaluates exactly like Polynomial.
+ * @note The coefficients must outlive the view.
+ */
+template <class T>
+class PolynomialView {
+public:
+    constexpr PolynomialView() noexcept = default;
+    constexpr explicit PolynomialView(std::span<const T> coefficients) noexcept : Coefficients(coefficients) {}
+
+    template <class A>
+    constexpr PolynomialView(const Polynomial<T, A>& p) noexcept : Coefficients(p.Coefficients) {}
+
+    template <class V>
+    constexpr auto operator()(const V& x) const -> decltype(std::declval<T>() * std::declval<V>()) {
+        __INSTRUMENT_OP("PolynomialView::operator()");
+        __INSTRUMENT_FLOPS(2 * Degree());
+        return __horner(Coefficients, x);
+    }
+
+    /// @brief Evaluate at every point of xs into out, as Polynomial::EvaluateBatch does.
+    template <std::ranges::contiguous_range X, std::ranges::contiguous_range R>
+    void EvaluateBatch(const X& xs, R&& out, ThreadPool& pool = DefaultThreadPool(), size_t grain = 4096) const {
+        const size_t n = std::ranges::size(xs);
+        if(std::ranges::size(out) != n)
+            throw std::logic_error("Attempted to evaluate a polynomial into an output of different length");
+
+        __INSTRUMENT_OP("PolynomialView::EvaluateBatch");
+        __INSTRUMENT_FLOPS(2 * Degree() * n);
+        __horner_batch(Coefficients, std::ranges::data(xs), std::ranges::data(out), n, pool, grain);
+    }
+
+    constexpr size_t Degree() const {
+        return Coefficients.size() > 0 ? Coefficients.size() - 1 : 0;
+    }
+
+    /// @brief An owning copy of the coefficients.
+    template <class A = std::allocator<T>>
+    constexpr Polynomial<T, A> ToPolynomial(const A& alloc = A()) const {
+        Polynomial<T, A> res(alloc);
+        res.Coefficients.assign(Coefficients.begin(), Coefficients.end());
+        return res;
+    }
+
+    std::span<const T> Coefficients;
+};
+
 
 template <class T, size_t N, T..._args>
 constexpr bool __pack_contains_trailing_zero() noexcept {
@@ -91,176 +214,192 @@ constexpr bool __pack_contains_trailing_zero() noexcept {
 
 // ############################################### OPERATORS FOR Polynomial #########################################
 
-template <class T>
-constexpr bool operator==(const Polynomial<T>& a, const Polynomial<T>& b) {
+template <class T, class A>
+constexpr bool operator==(const Polynomial<T, A>& a, const Polynomial<T, A>& b) {
     return a.Coefficients == b.Coefficients;
 }
 
-template <class T>
-constexpr Polynomial<T> operator+(const Polynomial<T>& a) {
-    return a;
+template <class T, class A>
+constexpr Polynomial<T, A> operator+(const Polynomial<T, A>& a) {
+    return Polynomial<T, A>(a, a.GetAllocator());
 }
 
-template <class T>
-constexpr Polynomial<T> operator-(const Polynomial<T>& a) {
-    Polynomial<T> res = a;
+template <class T, class A>
+constexpr Polynomial<T, A> operator-(const Polynomial<T, A>& a) {
+    Polynomial<T, A> res(a, a.GetAllocator());
     for(auto& x : res.Coefficients)
         x *= T(-1.0);
     return res;
 }
 
-template <class T>
-constexpr Polynomial<T> operator+(const Polynomial<T>& a, const Polynomial<T>& b) {
-    Polynomial<T> res = a;
-    return __polynomial_add(res, b);
+template <class T, class A>
+constexpr Polynomial<T, A> operator+(const Polynomial<T, A>& a, const Polynomial<T, A>& b) {
+    Polynomial<T, A> res(a, a.GetAllocator());
+    __polynomial_add(res, b);
+    return res;
 }
 
-template <class T>
-constexpr Polynomial<T>& operator+=(Polynomial<T>& a, const Polynomial<T>& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& operator+=(Polynomial<T, A>& a, const Polynomial<T, A>& b) {
     return __polynomial_add(a, b);
 }
 
-template <class T>
-constexpr Polynomial<T> operator+(const Polynomial<T>& a, const T& b) {
-    Polynomial<T> res = a;
-    return __polynomial_add(a, b);
+template <class T, class A>
+constexpr Polynomial<T, A> operator+(const Polynomial<T, A>& a, const T& b) {
+    Polynomial<T, A> res(a, a.GetAllocator());
+    __polynomial_add(res, b);
+    return res;
 }
 
-template <class T>
-constexpr Polynomial<T>& operator+=(Polynomial<T>& a, const T& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& operator+=(Polynomial<T, A>& a, const T& b) {
     return __polynomial_add(a, b);
 }
 
-template <class T>
-constexpr Polynomial<T> operator-(const Polynomial<T>& a, const Polynomial<T>& b) {
-    Polynomial<T> res = a;
-    return __polynomial_sub(a, b);
+template <class T, class A>
+constexpr Polynomial<T, A> operator-(const Polynomial<T, A>& a, const Polynomial<T, A>& b) {
+    Polynomial<T, A> res(a, a.GetAllocator());
+    __polynomial_sub(res, b);
+    return res;
 }
 
-template <class T>
-constexpr Polynomial<T>& operator-=(Polynomial<T>& a, const Polynomial<T>& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& operator-=(Polynomial<T, A>& a, const Polynomial<T, A>& b) {
     return __polynomial_sub(a, b);
 }
 
-template <class T>
-constexpr Polynomial<T> operator-(const Polynomial<T>& a, const T& b) {
-    Polynomial<T> res = a;
-    return __polynomial_sub(a, b);
+template <class T, class A>
+constexpr Polynomial<T, A> operator-(const Polynomial<T, A>& a, const T& b) {
+    Polynomial<T, A> res(a, a.GetAllocator());
+    __polynomial_sub(res, b);
+    return res;
 }
 
-template <class T>
-constexpr Polynomial<T>& operator-=(Polynomial<T>& a, const T& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& operator-=(Polynomial<T, A>& a, const T& b) {
     return __polynomial_sub(a, b);
 }
 
-template <class T>
-constexpr Polynomial<T> operator*(const Polynomial<T>& a, const Polynomial<T>& b) {
-    Polynomial<T> res = a;
-    return __polynomial_mul(res, b);
+template <class T, class A>
+constexpr Polynomial<T, A> operator*(const Polynomial<T, A>& a, const Polynomial<T, A>& b) {
+    Polynomial<T, A> res(a, a.GetAllocator());
+    __polynomial_mul(res, b);
+    return res;
 }
 
-template <class T>
-constexpr Polynomial<T>& operator*=(Polynomial<T>& a, const Polynomial<T>& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& operator*=(Polynomial<T, A>& a, const Polynomial<T, A>& b) {
     return __polynomial_mul(a, b);
 }
 
-template <class T>
-constexpr Polynomial<T> operator*(const Polynomial<T>& a, const T& b) {
-    Polynomial<T> res = a;
-    return __polynomial_mul(res, b);
+template <class T, class A>
+constexpr Polynomial<T, A> operator*(const Polynomial<T, A>& a, const T& b) {
+    Polynomial<T, A> res(a, a.GetAllocator());
+    __polynomial_mul(res, b);
+    return res;
 }
 
-template <class T>
-constexpr Polynomial<T>& operator*=(Polynomial<T>& a, const T& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& operator*=(Polynomial<T, A>& a, const T& b) {
     return __polynomial_mul(a, b);
 }
 
-template <class T>
-constexpr Polynomial<T> operator/(const Polynomial<T>& a, const T& b) {
-    Polynomial<T> res = a;
+template <class T, class A>
+constexpr Polynomial<T, A> operator/(const Polynomial<T, A>& a, const T& b) {
+    Polynomial<T, A> res(a, a.GetAllocator());
     for(auto& x : res.Coefficients)
         x /= b;
     return res;
 }
 
-template <class T>
-constexpr Polynomial<T>& operator/=(Polynomial<T>& a, const T& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& operator/=(Polynomial<T, A>& a, const T& b) {
     for(auto& x : a.Coefficients)
         x /= b;
     return a;
 }
 
-template <class T>
-constexpr Polynomial<T> operator/(const Polynomial<T>& a, const Polynomial<T>& b) {
-    return divide_and_remainder(a, b).first;
+template <class T, class A>
+constexpr Polynomial<T, A> operator/(const Polynomial<T, A>& a, const Polynomial<T, A>& b) {
+    return __polynomial_div(a, b).first;
 }
 
-template <class T>
-constexpr Polynomial<T>& operator/=(Polynomial<T>& a, const Polynomial<T>& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& operator/=(Polynomial<T, A>& a, const Polynomial<T, A>& b) {
     return a = a / b;
 }
 
-template <class T>
-constexpr Polynomial<T> operator%(const Polynomial<T>& a, const Polynomial<T>& b) {
-    return divide_and_remainder(a, b).second;
+template <class T, class A>
+constexpr Polynomial<T, A> operator%(const Polynomial<T, A>& a, const Polynomial<T, A>& b) {
+    return __polynomial_div(a, b).second;
 }
 
-template <class T>
-constexpr Polynomial<T>& operator%=(Polynomial<T>& a, const Polynomial<T>& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& operator%=(Polynomial<T, A>& a, const Polynomial<T, A>& b) {
     return a = a % b;
 }
 
-template <class T>
-constexpr Polynomial<T> operator*(double c, const Polynomial<T>& p) {
+template <class T, class A>
+constexpr Polynomial<T, A> operator*(double c, const Polynomial<T, A>& p) {
     return p * c;
 }
 
-template <class T> 
-constexpr Polynomial<T>& __polynomial_add(Polynomial<T>& a, const Polynomial<T>& b) {
-const size_t n = std::max(a.Coefficients.size(), b.Coefficients.size());
+template <class T, class A>
+constexpr Polynomial<T, A>& __polynomial_add(Polynomial<T, A>& a, const Polynomial<T, A>& b) {
+    __INSTRUMENT_OP("__polynomial_add");
+    __INSTRUMENT_FLOPS(b.Coefficients.size());
+    const size_t n = std::max(a.Coefficients.size(), b.Coefficients.size());
     if(a.Coefficients.size() < n) 
         a.Coefficients.resize(n);
     
-    for(size_t i = 0; i < n; i++)
+    for(size_t i = 0; i < b.Coefficients.size(); i++)
         a.Coefficients[i] += b.Coefficients[i];
     
     return a;
 }
 
-template <class T>
-constexpr Polynomial<T> __polynomial_add(const Polynomial<T>& a, const T& b) {
-    Polynomial<T> res = a;
+template <class T, class A>
+constexpr Polynomial<T, A>& __polynomial_add(Polynomial<T, A>& a, const T& b) {
     if(a.Coefficients.size() > 0) 
-        res.Coefficients[0] += b;
+        a.Coefficients[0] += b;
     else 
-        res.Coefficients.push_back(b);
+        a.Coefficients.assign(1, b);
 
-    res._normalize();
-    return res;
+    a._normalize();
+    return a;
 }
 
-template <class T> 
-constexpr Polynomial<T>& __polynomial_sub(Polynomial<T>& a, const Polynomial<T>& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& __polynomial_sub(Polynomial<T, A>& a, const Polynomial<T, A>& b) {
+    __INSTRUMENT_OP("__polynomial_sub");
+    __INSTRUMENT_FLOPS(b.Coefficients.size());
     const size_t n = std::max(a.Coefficients.size(), b.Coefficients.size());
 
     if(a.Coefficients.size() < n) 
         a.Coefficients.resize(n);
 
-    for(size_t i = 0; i < n; i++)
+    for(size_t i = 0; i < b.Coefficients.size(); i++)
         a.Coefficients[i] -= b.Coefficients[i];
 
     a._normalize();
     return a;
 }
 
-template <class T> 
-constexpr Polynomial<T>& __polynomial_mul(Polynomial<T>& a, const Polynomial<T>& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& __polynomial_sub(Polynomial<T, A>& a, const T& b) {
+    return __polynomial_add(a, T(-b));
+}
+
+template <class T, class A>
+constexpr Polynomial<T, A>& __polynomial_mul(Polynomial<T, A>& a, const Polynomial<T, A>& b) {
     const size_t deg = a.Degree(), deg_p = b.Degree();
+    __INSTRUMENT_OP("__polynomial_mul");
+    __INSTRUMENT_FLOPS(2 * (deg + 1) * (deg_p + 1));
     a.Coefficients.resize(deg + deg_p + 1);
 
     for(size_t i = 0; i <= deg; i++) {
         T base = a.Coefficients[deg - i]; 
-        a.Coefficients[deg - i] = T(0.0);
+        a.Coefficients[deg - i] = T(0);
         for(size_t j = 0; j <= deg_p; j++) {
             a.Coefficients[deg - i + deg_p - j] += base * b.Coefficients[deg_p - j];
         }
@@ -270,8 +409,8 @@ constexpr Polynomial<T>& __polynomial_mul(Polynomial<T>& a, const Polynomial<T>&
     return a;
 }
 
-template <class T>
-constexpr Polynomial<T>& __polynomial_mul(Polynomial<T>& a, const T& b) {
+template <class T, class A>
+constexpr Polynomial<T, A>& __polynomial_mul(Polynomial<T, A>& a, const T& b) {
     if(b == T(0)) 
         a.Coefficients.clear();
     else for(auto& x : a.Coefficients)
@@ -280,16 +419,17 @@ constexpr Polynomial<T>& __polynomial_mul(Polynomial<T>& a, const T& b) {
     return a;
 }
 
-template <class T> 
-constexpr std::pair<Polynomial<T>, Polynomial<T>> __polynomial_div(const Polynomial<T>& a, const Polynomial<T>& b) {
+template <class T, class A>
+constexpr std::pair<Polynomial<T, A>, Polynomial<T, A>> __polynomial_div(const Polynomial<T, A>& a, const Polynomial<T, A>& b) {
+    __INSTRUMENT_OP("__polynomial_div");
     if(a.Degree() < b.Degree())
-        return std::make_pair(Polynomial<T>(), a);
+        return std::make_pair(Polynomial<T, A>(a.GetAllocator()), a);
 
     const size_t deg_a = a.Degree(), deg_b = b.Degree(), deg_q = a.Degree() - b.Degree();
-    std::pair<Polynomial<T>, Polynomial<T>> res;
+    __INSTRUMENT_FLOPS((deg_q + 1) * (2 * deg_b + 3));
+    std::pair<Polynomial<T, A>, Polynomial<T, A>> res(Polynomial<T, A>(a.GetAllocator()), Polynomial<T, A>(a, a.GetAllocator()));
     auto&[q, r] = res;
 
-    r = a;
     q.Coefficients.resize(deg_q + 1);
 
     for(size_t i = 0; i <= deg_q; i++) {
@@ -299,7 +439,9 @@ constexpr std::pair<Polynomial<T>, Polynomial<T>> __polynomial_div(const Polynom
         T coef = r.Coefficients[deg_a - i] / b.Coefficients.back();
         q.Coefficients[deg_q - i] = coef;
 
-        for(size_t j = 0; j <= deg_b; j++)
+        // The leading term cancels by construction; subtracting would leave its rounding error in the remainder
+        r.Coefficients[deg_a - i] = T(0);
+        for(size_t j = 1; j <= deg_b; j++)
             r.Coefficients[deg_a - i - j] -= coef * b.Coefficients[deg_b - j]; 
     }
 
@@ -0,0 +1,455 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "other/Parallel.hpp"
+
+namespace Integrator {
+    enum GKRule {
+        G7K15, G10K21
+    };
+
+    template <class T>
+    struct QuadratureResult {
+        T Value;
+        T Error;
+        size_t Evaluations;
+    };
+
+    template <class T>
+    struct QuadratureOptions {
+        T AbsTol = T(1e-10);
+        T RelTol = T(1e-10);
+        size_t MaxSubintervals = 1000;  // Adaptive Gauss-Kronrod only
+        size_t MaxLevels = 12;          // Clenshaw-Curtis and tanh-sinh refinement levels
+        bool Parallel = false;          // Evaluate concurrently; the integrand must then be thread-safe
+    };
+
+    /// @brief An integrand that fills `ys[i] = f(xs[i])` for a whole span of abscissae in one call.
+    template <class F, class T>
+    concept BatchIntegrand = std::invocable<F&, std::span<const T>, std::span<T>>;
+
+    template <class F, class T>
+    concept Integrand = BatchIntegrand<F, T> || std::invocable<F&, T>;
+
+    template <class T, Integrand<T> F>
+    constexpr void __evaluate_batch(F& f, std::span<const T> xs, std::span<T> ys) {
+        if constexpr(BatchIntegrand<F, T>)
+            f(xs, ys);
+        else for(size_t i = 0; i < xs.size(); i++)
+            ys[i] = f(xs[i]);
+    }
+
+    template <class T>
+    constexpr bool __within_tolerance(const T& err, const T& value, const QuadratureOptions<T>& opts) {
+        using std::abs;
+        return err <= std::max(opts.AbsTol, opts.RelTol * abs(value));
+    }
+};
+
+// ############################################### GAUSS-KRONROD #########################################
+
+namespace Integrator {
+    // Abscissae are on [0, 1] in decreasing order with the centre last; Gauss weights are
+    // zero at the Kronrod-only abscissae. Values are those of QUADPACK's qk15 and qk21.
+    template <class T, GKRule R> struct __gk_table;
+
+    template <class T>
+    struct __gk_table<T, G7K15> {
+        static constexpr size_t N = 8;
+        static constexpr std::array<T, N> Nodes = {
+            T(0.991455371120812639206854697526329L), T(0.949107912342758524526189684047851L),
+            T(0.864864423359769072789712788640926L), T(0.741531185599394439863864773280788L),
+            T(0.586087235467691130294144845693013L), T(0.405845151377397166906606412076961L),
+            T(0.207784955007898467600689403773245L), T(0.0L)
+        };
+        static constexpr std::array<T, N> KronrodWeights = {
+            T(0.022935322010529224963732008058970L), T(0.063092092629978553290700663189204L),
+            T(0.104790010322250183839876322541518L), T(0.140653259715525918745189590510238L),
+            T(0.169004726639267902826583426598550L), T(0.190350578064785409913256402421014L),
+            T(0.204432940075298892414161999234649L), T(0.209482141084727828012999174891714L)
+        };
+        static constexpr std::array<T, N> GaussWeights = {
+            T(0.0L), T(0.129484966168869693270611432679082L),
+            T(0.0L), T(0.279705391489276667901467771423780L),
+            T(0.0L), T(0.381830050505118944950369775488975L),
+            T(0.0L), T(0.417959183673469387755102040816327L)
+        };
+    };
+
+    template <class T>
+    struct __gk_table<T, G10K21> {
+        static constexpr size_t N = 11;
+        static constexpr std::array<T, N> Nodes = {
+            T(0.995657163025808080735527280689003L), T(0.973906528517171720077964012084452L),
+            T(0.930157491355708226001207180059508L), T(0.865063366688984510732096688423493L),
+            T(0.780817726586416897063717578345042L), T(0.679409568299024406234327365114874L),
+            T(0.562757134668604683339000099272694L), T(0.433395394129247190799265943165784L),
+            T(0.294392862701460198131126603103866L), T(0.148874338981631210884826001129720L),
+            T(0.0L)
+        };
+        static constexpr std::array<T, N> KronrodWeights = {
+            T(0.011694638867371874278064396062192L), T(0.032558162307964727478818972459390L),
+            T(0.054755896574351996031381300244580L), T(0.075039674810919952767043140916190L),
+            T(0.093125454583697605535065465083366L), T(0.109387158802297641899210590325805L),
+            T(0.123491976262065851077208932240836L), T(0.134709217311473325928054001771707L),
+            T(0.142775938577060080797094273138717L), T(0.147739104901338491374841515972068L),
+            T(0.149445554002916905664936468389821L)
+        };
+        static constexpr std::array<T, N> GaussWeights = {
+            T(0.0L), T(0.066671344308688137593568809893332L),
+            T(0.0L), T(0.149451349150580593145776339657697L),
+            T(0.0L), T(0.219086362515982043995534934228163L),
+            T(0.0L), T(0.269266719309996355091226921569469L),
+            T(0.0L), T(0.295524224714752870173892994651338L),
+            T(0.0L)
+        };
+    };
+
+    template <class T>
+    struct __gk_subinterval {
+        T A, B, Value, Error;
+
+        // Ordered so that std::push_heap/std::pop_heap keep the worst subinterval on top
+        constexpr bool operator<(const __gk_subinterval& other) const { return Error < other.Error; }
+    };
+
+    template <GKRule R, class T, Integrand<T> F>
+    __gk_subinterval<T> __gk_apply(F& f, const T& a, const T& b) {
+        using table = __gk_table<T, R>;
+        using std::abs, std::pow;
+        constexpr size_t N = table::N;
+        constexpr size_t M = 2 * N - 1;
+
+        const T centre = (a + b) * T(0.5);
+        const T half = (b - a) * T(0.5);
+
+        std::array<T, M> xs, ys;
+        for(size_t i = 0; i < N - 1; i++) {
+            xs[2 * i] = centre - half * table::Nodes[i];
+            xs[2 * i + 1] = centre + half * table::Nodes[i];
+        }
+        xs[M - 1] = centre;
+        __evaluate_batch<T>(f, std::span<const T>(xs), std::span<T>(ys));
+
+        T kronrod = table::KronrodWeights[N - 1] * ys[M - 1];
+        T gauss = table::GaussWeights[N - 1] * ys[M - 1];
+        for(size_t i = 0; i < N - 1; i++) {
+            kronrod += table::KronrodWeights[i] * (ys[2 * i] + ys[2 * i + 1]);
+            gauss += table::GaussWeights[i] * (ys[2 * i] + ys[2 * i + 1]);
+        }
+
+        // QUADPACK's error scaling: |K - G| relative to the variation of f around its mean
+        const T mean = kronrod * T(0.5);
+        T variation = table::KronrodWeights[N - 1] * abs(ys[M - 1] - mean);
+        for(size_t i = 0; i < N - 1; i++)
+            variation += table::KronrodWeights[i] * (abs(ys[2 * i] - mean) + abs(ys[2 * i + 1] - mean));
+
+        T err = abs((kronrod - gauss) * half);
+        variation *= abs(half);
+        if(variation != T(0) && err != T(0))
+            err = variation * std::min(T(1), pow(T(200) * err / variation, T(1.5)));
+
+        return { a, b, kronrod * half, err };
+    }
+
+    /**
+     * @brief Adaptive Gauss-Kronrod quadrature of `f` over `[a, b]`. The subintervals with the largest
+     * error estimates are bisected first; when `opts.Parallel` is set, one batch of them per available
+     * core is bisected and evaluated concurrently on each step.
+     */
+    template <class T, Integrand<T> F>
+    QuadratureResult<T> GaussKronrod(F f, const T& a, const T& b, const QuadratureOptions<T>& opts = {}, GKRule rule = G7K15) {
+        auto apply = [&](const T& lo, const T& hi) {
+            return rule == G7K15 ? __gk_apply<G7K15>(f, lo, hi) : __gk_apply<G10K21>(f, lo, hi);
+        };
+        const size_t evals_per_interval = rule == G7K15 ? 15 : 21;
+
+        std::vector<__gk_subinterval<T>> heap = { apply(a, b) };
+        T value = heap[0].Value, err = heap[0].Error;
+        size_t evaluations = evals_per_interval;
+
+        std::vector<__gk_subinterval<T>> parents, children;
+        const size_t batch = opts.Parallel ? HardwareConcurrency() : 1;
+
+        while(!__within_tolerance(err, value, opts) && heap.size() < opts.MaxSubintervals) {
+            parents.clear();
+            while(parents.size() < batch && !heap.empty() && heap.size() + parents.size() < opts.MaxSubintervals) {
+                std::pop_heap(heap.begin(), heap.end());
+                const auto& worst = heap.back();
+                const T mid = (worst.A + worst.B) * T(0.5);
+
+                // Stop refining once bisection no longer produces distinct floating-point endpoints
+                if(!(worst.A < mid && mid < worst.B)) {
+                    std::push_heap(heap.begin(), heap.end());
+                    break;
+                }
+
+                parents.push_back(worst);
+                heap.pop_back();
+            }
+
+            if(parents.empty())
+                break;
+
+            children.resize(2 * parents.size());
+            auto bisect = [&](size_t i) {
+                const auto& p = parents[i / 2];
+                const T mid = (p.A + p.B) * T(0.5);
+                children[i] = (i % 2 == 0) ? apply(p.A, mid) : apply(mid, p.B);
+            };
+
+            if(opts.Parallel)
+                ParallelFor(0, children.size(), bisect);
+            else for(size_t i = 0; i < children.size(); i++)
+                bisect(i);
+
+            for(auto& p : parents)
+                value -= p.Value, err -= p.Error;
+            for(auto& c : children) {
+                value += c.Value, err += c.Error;
+                heap.push_back(c);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            evaluations += children.size() * evals_per_interval;
+        }
+
+        // Re-accumulate to discard the drift from the incremental updates
+        value = T(0), err = T(0);
+        for(auto& s : heap)
+            value += s.Value, err += s.Error;
+
+        return { value, err, evaluations };
+    }
+};
+
+// ############################################### CLENSHAW-CURTIS #########################################
+
+namespace Integrator {
+    template <class T>
+    struct __cc_rule {
+        std::vector<T> Nodes;    // cos(k pi / n) for k = 0..n, i.e. the nodes of CreateChebyshevNodes(f, -1, 1, n + 1)
+        std::vector<T> Weights;
+    };
+
+    /// @brief The (n + 1)-point Clenshaw-Curtis rule on [-1, 1], computed once per n and cached for the process.
+    template <class T>
+    const __cc_rule<T>& __clenshaw_curtis_rule(size_t n) {
+        static std::mutex mtx;
+        static std::map<size_t, __cc_rule<T>> cache;
+
+        std::lock_guard lock(mtx);
+        if(auto it = cache.find(n); it != cache.end())
+            return it->second;
+
+        using namespace std::numbers;
+        __cc_rule<T> rule;
+        rule.Nodes.resize(n + 1);
+        rule.Weights.resize(n + 1);
+
+        for(size_t k = 0; k <= n; k++) {
+            rule.Nodes[k] = std::cos(T(k) * pi_v<T> / T(n));
+
+            T s = T(0);
+            for(size_t j = 1; j <= n / 2; j++) {
+                const T bj = (2 * j == n) ? T(1) : T(2);
+                s += bj / T(4 * j * j - 1) * std::cos(T(2 * j * k) * pi_v<T> / T(n));
+            }
+
+            const T ck = (k == 0 || k == n) ? T(1) : T(2);
+            rule.Weights[k] = ck / T(n) * (T(1) - s);
+        }
+
+        return cache.emplace(n, std::move(rule)).first->second;
+    }
+
+    /**
+     * @brief Integrate the interpolant through the output of `Interpolator::CreateChebyshevNodes`
+     * with the matching Clenshaw-Curtis rule, reusing the samples that are already there.
+     */
+    template <class T>
+    T ClenshawCurtis(const std::vector<std::pair<T, T>>& points) {
+        if(points.size() < 2)
+            throw std::logic_error("Attempted to integrate over less than two nodes");
+
+        const auto& rule = __clenshaw_curtis_rule<T>(points.size() - 1);
+        const T half = (points.front().first - points.back().first) * T(0.5);
+
+        T res = T(0);
+        for(size_t k = 0; k < points.size(); k++)
+            res += rule.Weights[k] * points[k].second;
+
+        return res * half;
+    }
+
+    /**
+     * @brief Nested Clenshaw-Curtis quadrature of `f` over `[a, b]`. Each level doubles the number of
+     * nodes, so every previous sample is reused and only the new odd-indexed nodes are evaluated.
+     */
+    template <class T, Integrand<T> F>
+    QuadratureResult<T> ClenshawCurtis(F f, const T& a, const T& b, const QuadratureOptions<T>& opts = {}) {
+        using std::abs;
+        const T centre = (a + b) * T(0.5);
+        const T half = (b - a) * T(0.5);
+
+        size_t n = 8;
+        std::vector<T> ys(n + 1), next_ys, xs;
+        {
+            const auto& rule = __clenshaw_curtis_rule<T>(n);
+            xs.resize(n + 1);
+            for(size_t k = 0; k <= n; k++)
+                xs[k] = centre + half * rule.Nodes[k];
+            __evaluate_batch<T>(f, std::span<const T>(xs), std::span<T>(ys));
+        }
+
+        auto integrate = [&](const std::vector<T>& samples, size_t n_) {
+            const auto& rule = __clenshaw_curtis_rule<T>(n_);
+            T res = T(0);
+            for(size_t k = 0; k <= n_; k++)
+                res += rule.Weights[k] * samples[k];
+            return res * half;
+        };
+
+        T value = integrate(ys, n);
+        T err = std::numeric_limits<T>::max();
+        size_t evaluations = n + 1;
+
+        for(size_t level = 0; level < opts.MaxLevels && !__within_tolerance(err, value, opts); level++) {
+            const size_t n2 = 2 * n;
+            const auto& rule = __clenshaw_curtis_rule<T>(n2);
+
+            xs.resize(n);
+            for(size_t k = 0; k < n; k++)
+                xs[k] = centre + half * rule.Nodes[2 * k + 1];
+
+            next_ys.resize(n2 + 1);
+            std::vector<T> odd(n);
+            __evaluate_batch<T>(f, std::span<const T>(xs), std::span<T>(odd));
+            for(size_t k = 0; k <= n; k++)
+                next_ys[2 * k] = ys[k];
+            for(size_t k = 0; k < n; k++)
+                next_ys[2 * k + 1] = odd[k];
+
+            std::swap(ys, next_ys);
+            evaluations += n;
+            n = n2;
+
+            const T next_value = integrate(ys, n);
+            err = abs(next_value - value);
+            value = next_value;
+        }
+
+        return { value, err, evaluations };
+    }
+};
+
+// ############################################### TANH-SINH #########################################
+
+namespace Integrator {
+    template <class T>
+    struct __ts_node {
+        T Complement;   // 1 - tanh(pi/2 sinh t), computed without cancellation
+        T Weight;       // pi/2 cosh t / cosh^2(pi/2 sinh t)
+    };
+
+    /**
+     * @brief The tanh-sinh nodes first introduced at refinement level `level` (step 2^-level),
+     * restricted to t >= 0 and truncated once the complement or the weight underflows.
+     */
+    template <class T>
+    const std::vector<__ts_node<T>>& __tanh_sinh_level(size_t level) {
+        static std::mutex mtx;
+        static std::deque<std::vector<__ts_node<T>>> cache;
+
+        std::lock_guard lock(mtx);
+        while(cache.size() <= level) {
+            using namespace std::numbers;
+            const size_t l = cache.size();
+            const T h = std::ldexp(T(1), -int(l));
+            std::vector<__ts_node<T>> nodes;
+
+            // Level 0 holds every integer t (including the centre); later levels only odd multiples of h
+            for(size_t j = (l == 0 ? 0 : 1); ; j += (l == 0 ? 1 : 2)) {
+                const T t = T(j) * h;
+                const T u = pi_v<T> * T(0.5) * std::sinh(t);
+                const T e = std::exp(-T(2) * u);
+                const T complement = T(2) * e / (T(1) + e);
+                const T cu = std::cosh(u);
+                const T w = pi_v<T> * T(0.5) * std::cosh(t) / (cu * cu);
+
+                if(!(complement > std::numeric_limits<T>::min()) || !(w > std::numeric_limits<T>::min()))
+                    break;
+                nodes.push_back({ complement, w });
+            }
+            cache.push_back(std::move(nodes));
+        }
+
+        return cache[level];
+    }
+
+    /**
+     * @brief Tanh-sinh (double exponential) quadrature of `f` over `[a, b]`, which tolerates integrable
+     * singularities at the endpoints. Abscissae that round onto an endpoint are never evaluated.
+     */
+    template <class T, Integrand<T> F>
+    QuadratureResult<T> TanhSinh(F f, const T& a, const T& b, const QuadratureOptions<T>& opts = {}) {
+        using std::abs;
+        const T half = (b - a) * T(0.5);
+
+        std::vector<T> xs, ws, ys;
+        T sum = T(0);
+        T value = T(0), err = std::numeric_limits<T>::max();
+        size_t evaluations = 0;
+
+        for(size_t level = 0; level <= opts.MaxLevels; level++) {
+            const auto& nodes = __tanh_sinh_level<T>(level);
+
+            xs.clear(), ws.clear();
+            for(size_t i = 0; i < nodes.size(); i++) {
+                const auto& [complement, w] = nodes[i];
+                const T left = a + half * complement;
+                const T right = b - half * complement;
+
+                if(level == 0 && i == 0) {
+                    xs.push_back(left), ws.push_back(w);
+                    continue;
+                }
+                if(a < left && left < b)
+                    xs.push_back(left), ws.push_back(w);
+                if(a < right && right < b)
+                    xs.push_back(right), ws.push_back(w);
+            }
+
+            ys.resize(xs.size());
+            __evaluate_batch<T>(f, std::span<const T>(xs), std::span<T>(ys));
+            evaluations += xs.size();
+
+            T level_sum = T(0);
+            for(size_t i = 0; i < ys.size(); i++)
+                level_sum += ws[i] * ys[i];
+            sum += level_sum;
+
+            const T next_value = sum * half * std::ldexp(T(1), -int(level));
+            if(level > 0)
+                err = abs(next_value - value);
+            value = next_value;
+
+            if(level >= 2 && __within_tolerance(err, value, opts))
+                break;
+        }
+
+        return { value, err, evaluations };
+    }
+};
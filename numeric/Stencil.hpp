@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <immintrin.h>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace Differentiator {
+    /**
+     * @brief Fornberg's algorithm for the weights of the `order`-th derivative at `x0` over arbitrary,
+     * distinct sample offsets. Usable in constant expressions.
+     */
+    template <class T, size_t NPts>
+    constexpr std::array<T, NPts> FornbergWeights(const std::array<T, NPts>& offsets, size_t order, const T& x0 = T(0)) {
+        if(order >= NPts)
+            throw std::logic_error("Attempted to build a stencil with fewer points than the derivative order requires");
+
+        // C[j][k] holds the weight of offsets[j] for the k-th derivative, k <= order
+        std::array<std::array<T, NPts>, NPts> C = {};
+        T c1 = T(1), c4 = offsets[0] - x0;
+        C[0][0] = T(1);
+
+        for(size_t i = 1; i < NPts; i++) {
+            const size_t mn = std::min(i, order);
+            T c2 = T(1);
+            const T c5 = c4;
+            c4 = offsets[i] - x0;
+
+            for(size_t j = 0; j < i; j++) {
+                const T c3 = offsets[i] - offsets[j];
+                c2 *= c3;
+
+                if(j == i - 1) {
+                    for(size_t k = mn; k >= 1; k--)
+                        C[i][k] = c1 * (T(k) * C[i - 1][k - 1] - c5 * C[i - 1][k]) / c2;
+                    C[i][0] = -c1 * c5 * C[i - 1][0] / c2;
+                }
+
+                for(size_t k = mn; k >= 1; k--)
+                    C[j][k] = (c4 * C[j][k] - T(k) * C[j][k - 1]) / c3;
+                C[j][0] = c4 * C[j][0] / c3;
+            }
+            c1 = c2;
+        }
+
+        std::array<T, NPts> res = {};
+        for(size_t j = 0; j < NPts; j++)
+            res[j] = C[j][order];
+
+        return res;
+    }
+
+    /// @brief Weights of a finite-difference stencil on a unit-spaced grid; divide the result by h^order.
+    template <class T, size_t NPts>
+    struct Stencil {
+        static constexpr size_t Size = NPts;
+
+        std::array<int, NPts> Offsets;
+        std::array<T, NPts> Weights;
+    };
+
+    template <class T, size_t NPts>
+    constexpr Stencil<T, NPts> MakeStencil(const std::array<int, NPts>& offsets, size_t order) {
+        std::array<T, NPts> z = {};
+        for(size_t i = 0; i < NPts; i++)
+            z[i] = T(offsets[i]);
+
+        return { offsets, FornbergWeights(z, order) };
+    }
+
+    template <size_t Order, size_t Accuracy>
+    constexpr size_t __central_points = 2 * ((Order + 1) / 2) - 1 + Accuracy;
+
+    template <size_t Order, size_t Accuracy>
+    constexpr size_t __one_sided_points = Order + Accuracy;
+
+    /// @brief The symmetric stencil for the `Order`-th derivative with truncation error O(h^Accuracy).
+    template <class T, size_t Order, size_t Accuracy>
+    requires (Order >= 1 && Accuracy >= 2 && Accuracy % 2 == 0)
+    constexpr auto CentralStencil = []() {
+        constexpr size_t NPts = __central_points<Order, Accuracy>;
+        std::array<int, NPts> offsets = {};
+        for(size_t i = 0; i < NPts; i++)
+            offsets[i] = int(i) - int(NPts / 2);
+        return MakeStencil<T>(offsets, Order);
+    }();
+
+    /**
+     * @brief One-sided replacements for the central stencil near the ends of a grid, with the same order of
+     * accuracy. Element `i` serves grid point `i` (left) or `n - 1 - i` (right).
+     */
+    template <class T, size_t Order, size_t Accuracy>
+    requires (Order >= 1 && Accuracy >= 2 && Accuracy % 2 == 0)
+    constexpr auto BoundaryStencils = []() {
+        constexpr size_t NPts = __one_sided_points<Order, Accuracy>;
+        constexpr size_t P = __central_points<Order, Accuracy> / 2;
+
+        std::pair<std::array<Stencil<T, NPts>, P>, std::array<Stencil<T, NPts>, P>> res = {};
+        auto& [left, right] = res;
+        for(size_t i = 0; i < P; i++) {
+            std::array<int, NPts> lo = {}, hi = {};
+            for(size_t k = 0; k < NPts; k++) {
+                lo[k] = int(k) - int(i);
+                hi[k] = int(i) - int(NPts - 1) + int(k);
+            }
+            left[i] = MakeStencil<T>(lo, Order);
+            right[i] = MakeStencil<T>(hi, Order);
+        }
+        return res;
+    }();
+
+    // dst[j] = sum_k w[k] * src[offsets[k] * stride + j] for j in [0, len)
+    template <class T, size_t NPts>
+    void __stencil_rows(T* dst, const T* src, ptrdiff_t stride, const std::array<int, NPts>& offsets, const std::array<T, NPts>& w, size_t len) {
+        size_t j = 0;
+#if defined(__AVX512F__)
+        if constexpr(std::same_as<T, double>) {
+            for(; j + 8 <= len; j += 8) {
+                __m512d acc = _mm512_setzero_pd();
+                for(size_t k = 0; k < NPts; k++)
+                    acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_set1_pd(w[k]), _mm512_loadu_pd(src + offsets[k] * stride + j)));
+                _mm512_storeu_pd(dst + j, acc);
+            }
+        }
+#endif
+#if defined(__AVX__)
+        if constexpr(std::same_as<T, double>) {
+            for(; j + 4 <= len; j += 4) {
+                __m256d acc = _mm256_setzero_pd();
+                for(size_t k = 0; k < NPts; k++)
+                    acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_set1_pd(w[k]), _mm256_loadu_pd(src + offsets[k] * stride + j)));
+                _mm256_storeu_pd(dst + j, acc);
+            }
+        }
+        else if constexpr(std::same_as<T, float>) {
+            for(; j + 8 <= len; j += 8) {
+                __m256 acc = _mm256_setzero_ps();
+                for(size_t k = 0; k < NPts; k++)
+                    acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(w[k]), _mm256_loadu_ps(src + offsets[k] * stride + j)));
+                _mm256_storeu_ps(dst + j, acc);
+            }
+        }
+#endif
+        for(; j < len; j++) {
+            T acc = T(0);
+            for(size_t k = 0; k < NPts; k++)
+                acc += w[k] * src[offsets[k] * stride + ptrdiff_t(j)];
+            dst[j] = acc;
+        }
+    }
+
+    template <class T, size_t NPts>
+    constexpr Stencil<T, NPts> __scaled(Stencil<T, NPts> s, const T& scale) {
+        for(auto& w : s.Weights)
+            w *= scale;
+        return s;
+    }
+
+    /**
+     * @brief Differentiate a row-major 1-D/2-D/3-D grid with uniform spacing `h` along `axis`, writing to `out`.
+     * The interior uses `CentralStencil`, the outermost points `BoundaryStencils`. When the axis is not the
+     * innermost one, the sweep is blocked along the contiguous dimension so the rows of a stencil stay in cache.
+     * @note `in` and `out` must not overlap.
+     */
+    template <size_t Order, size_t Accuracy, class T, size_t D>
+    requires (D >= 1 && D <= 3)
+    void ApplyStencil(std::span<const T> in, std::span<T> out, const std::array<size_t, D>& extents, size_t axis, const T& h) {
+        constexpr size_t NC = __central_points<Order, Accuracy>;
+        constexpr size_t NB = __one_sided_points<Order, Accuracy>;
+        constexpr size_t P = NC / 2;
+        constexpr size_t Block = 512;
+
+        if(axis >= D)
+            throw std::logic_error("Attempted to differentiate along a nonexistent axis");
+
+        size_t outer = 1, inner = 1;
+        for(size_t d = 0; d < axis; d++) outer *= extents[d];
+        for(size_t d = axis + 1; d < D; d++) inner *= extents[d];
+        const size_t n = extents[axis];
+        if(in.size() != outer * n * inner || out.size() != in.size())
+            throw std::logic_error("Attempted to apply a stencil to buffers that do not match the grid extents");
+        if(n < NB)
+            throw std::logic_error("Attempted to apply a stencil to an axis shorter than its boundary stencils");
+
+        T scale = T(1);
+        for(size_t i = 0; i < Order; i++)
+            scale /= h;
+
+        const auto central = __scaled(CentralStencil<T, Order, Accuracy>, scale);
+        std::array<Stencil<T, NB>, P> left, right;
+        for(size_t i = 0; i < P; i++) {
+            left[i] = __scaled(BoundaryStencils<T, Order, Accuracy>.first[i], scale);
+            right[i] = __scaled(BoundaryStencils<T, Order, Accuracy>.second[i], scale);
+        }
+
+        const ptrdiff_t stride = ptrdiff_t(inner);
+        for(size_t o = 0; o < outer; o++) {
+            const T* src = in.data() + o * n * inner;
+            T* dst = out.data() + o * n * inner;
+
+            if(inner == 1) {
+                // The axis is contiguous: vectorise across grid points
+                __stencil_rows(dst + P, src + P, 1, central.Offsets, central.Weights, n - 2 * P);
+                for(size_t i = 0; i < P; i++) {
+                    __stencil_rows(dst + i, src + i, 1, left[i].Offsets, left[i].Weights, 1);
+                    __stencil_rows(dst + n - 1 - i, src + n - 1 - i, 1, right[i].Offsets, right[i].Weights, 1);
+                }
+                continue;
+            }
+
+            // The axis is strided: vectorise across the contiguous dimension, one cache block at a time
+            for(size_t j0 = 0; j0 < inner; j0 += Block) {
+                const size_t len = std::min(Block, inner - j0);
+                for(size_t i = 0; i < P; i++)
+                    __stencil_rows(dst + i * inner + j0, src + i * inner + j0, stride, left[i].Offsets, left[i].Weights, len);
+                for(size_t i = P; i < n - P; i++)
+                    __stencil_rows(dst + i * inner + j0, src + i * inner + j0, stride, central.Offsets, central.Weights, len);
+                for(size_t i = 0; i < P; i++) {
+                    const size_t r = n - 1 - i;
+                    __stencil_rows(dst + r * inner + j0, src + r * inner + j0, stride, right[i].Offsets, right[i].Weights, len);
+                }
+            }
+        }
+    }
+
+    template <size_t Order, size_t Accuracy, class T>
+    void ApplyStencil(std::span<const T> in, std::span<T> out, const T& h) {
+        ApplyStencil<Order, Accuracy, T, 1>(in, out, std::array<size_t, 1>{ in.size() }, 0, h);
+    }
+};
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "DoubleDouble.hpp"
+#include "Interpolators.hpp"
+#include "Polynomial.hpp"
+#include "other/MappedFile.hpp"
+
+/**
+ * A binary file of precomputed tables: polynomial coefficients and barycentric node/weight sets, each under a
+ * name, written once offline by a Tables::Writer (or the tools/tables program) and read back zero-copy as
+ * PolynomialView and BarycentricView, so loading costs a mapping rather than sampling and weighing again.
+ *
+ * Layout, version 1, in the byte order of the writing machine:
+ *     [0, 64)            header: magic "MPHYTBL", version, byte-order mark, entry count, file size
+ *     [64, 64 + 128n)    n directory entries sorted by name: name, kind, scalar type, length, array offsets
+ *     then the arrays    each starting on a multiple of 64 bytes
+ * A polynomial has one array, its coefficients in increasing degree; a barycentric set has three of equal
+ * length, the abscissae, the values and the weights. Scalars are float, double or DoubleDouble.
+ *
+ * The reader checks everything it relies on when it opens a file and rejects a different version or byte
+ * order instead of converting, since conversion would need a copy.
+ */
+namespace Tables {
+    inline constexpr uint32_t FormatVersion = 1;
+    inline constexpr size_t ArrayAlignment = 64;
+
+    enum class TableKind : uint32_t {
+        Polynomial = 1,
+        Barycentric = 2
+    };
+
+    struct EntryInfo {
+        std::string_view Name;
+        TableKind Kind;
+        std::string_view Scalar;
+        size_t Length;
+    };
+
+    inline constexpr char __magic[8] = { 'M', 'P', 'H', 'Y', 'T', 'B', 'L', '\0' };
+    inline constexpr uint32_t __byte_order_mark = 0x01020304;
+
+    struct __file_header {
+        char Magic[8];
+        uint32_t Version;
+        uint32_t ByteOrder;
+        uint64_t EntryCount;
+        uint64_t FileSize;
+        uint8_t Reserved[32];
+    };
+
+    struct __entry {
+        char Name[64];
+        uint32_t Kind;
+        uint32_t Scalar;
+        uint64_t Length;
+        uint64_t Offsets[3];
+        uint8_t Reserved[24];
+    };
+
+    static_assert(sizeof(__file_header) == 64 && sizeof(__entry) == 128);
+
+    // The code of each scalar type a table may hold, and its size
+    template <class T>
+    inline constexpr uint32_t __scalar_code = 0;
+    template <>
+    inline constexpr uint32_t __scalar_code<float> = 1;
+    template <>
+    inline constexpr uint32_t __scalar_code<double> = 2;
+    template <>
+    inline constexpr uint32_t __scalar_code<DoubleDouble> = 3;
+
+    constexpr size_t __scalar_size(uint32_t code) noexcept {
+        switch(code) {
+            case 1: return sizeof(float);
+            case 2: return sizeof(double);
+            case 3: return sizeof(DoubleDouble);
+            default: return 0;
+        }
+    }
+
+    constexpr std::string_view __scalar_name(uint32_t code) noexcept {
+        switch(code) {
+            case 1: return "float";
+            case 2: return "double";
+            case 3: return "DoubleDouble";
+            default: return "";
+        }
+    }
+
+    constexpr size_t __array_count(TableKind kind) noexcept {
+        return kind == TableKind::Polynomial ? 1 : 3;
+    }
+
+    template <class T>
+    concept TableScalar = __scalar_code<T> != 0 && std::is_trivially_copyable_v<T>;
+
+    /**
+     * @brief Reads the tables of a file in memory, either mapped and owned by the reader or any byte range the
+     * caller keeps alive, such as an embedded array.
+     * @note Views returned by the reader point into its bytes: they stay valid as long as the reader or
+     * the reader it was moved to, or for a borrowed range as long as the range.
+     */
+    class Reader {
+    public:
+        /// @brief Maps the file at path; see MappedFile.
+        explicit Reader(const std::string& path) : Reader(MappedFile(path)) {}
+
+        explicit Reader(MappedFile file) : File(std::move(file)) {
+            __open(File.Bytes());
+        }
+
+        /// @brief Reads tables from bytes, which must start on an 8-byte boundary and outlive the reader.
+        explicit Reader(std::span<const std::byte> bytes) {
+            __open(bytes);
+        }
+
+        size_t Size() const noexcept {
+            return Count;
+        }
+
+        EntryInfo Entry(size_t i) const {
+            if(i >= Count)
+                throw std::logic_error("Attempted to read a table entry past the end of the directory");
+            return { Entries[i].Name, TableKind(Entries[i].Kind), __scalar_name(Entries[i].Scalar), size_t(Entries[i].Length) };
+        }
+
+        bool Contains(std::string_view name) const noexcept {
+            return __find(name) != nullptr;
+        }
+
+        template <TableScalar T>
+        PolynomialView<T> GetPolynomial(std::string_view name) const {
+            const __entry& e = __get<T>(name, TableKind::Polynomial);
+            return PolynomialView<T>(__array<T>(e, 0));
+        }
+
+        template <TableScalar T>
+        Interpolator::Lagrange::BarycentricView<T> GetBarycentric(std::string_view name) const {
+            const __entry& e = __get<T>(name, TableKind::Barycentric);
+            return Interpolator::Lagrange::BarycentricView<T>(__array<T>(e, 0), __array<T>(e, 1), __array<T>(e, 2));
+        }
+
+    private:
+        void __open(std::span<const std::byte> bytes) {
+            if(reinterpret_cast<uintptr_t>(bytes.data()) % alignof(__entry) != 0)
+                throw std::logic_error("Attempted to read tables from misaligned memory");
+            if(bytes.size() < sizeof(__file_header))
+                throw std::logic_error("Attempted to read a table file shorter than its header");
+
+            __file_header header;
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            if(std::memcmp(header.Magic, __magic, sizeof(__magic)) != 0)
+                throw std::logic_error("Attempted to read a file that is not a table file");
+            if(header.Version != FormatVersion)
+                throw std::logic_error("Attempted to read a table file of unsupported version " + std::to_string(header.Version));
+            if(header.ByteOrder != __byte_order_mark)
+                throw std::logic_error("Attempted to read a table file written in another byte order");
+            if(header.FileSize != bytes.size())
+                throw std::logic_error("Attempted to read a truncated table file");
+            if(header.EntryCount > (bytes.size() - sizeof(__file_header)) / sizeof(__entry))
+                throw std::logic_error("Attempted to read a table file whose directory overruns it");
+
+            Count = size_t(header.EntryCount);
+            Entries = reinterpret_cast<const __entry*>(bytes.data() + sizeof(__file_header));
+
+            // Check every entry once here so lookups can trust them
+            for(size_t i = 0; i < Count; i++) {
+                const __entry& e = Entries[i];
+                if(std::find(e.Name, e.Name + sizeof(e.Name), '\0') == e.Name + sizeof(e.Name))
+                    throw std::logic_error("Attempted to read a table file with an unterminated name");
+                if(i > 0 && !(std::string_view(Entries[i - 1].Name) < std::string_view(e.Name)))
+                    throw std::logic_error("Attempted to read a table file whose directory is not sorted");
+                if(e.Kind != uint32_t(TableKind::Polynomial) && e.Kind != uint32_t(TableKind::Barycentric))
+                    throw std::logic_error("Attempted to read a table of unknown kind");
+
+                const size_t scalar = __scalar_size(e.Scalar);
+                if(scalar == 0)
+                    throw std::logic_error("Attempted to read a table of unknown scalar type");
+                if(e.Length > bytes.size() / scalar)
+                    throw std::logic_error("Attempted to read a table longer than its file");
+
+                for(size_t k = 0; k < __array_count(TableKind(e.Kind)); k++)
+                    if(e.Offsets[k] % ArrayAlignment != 0 || e.Offsets[k] > bytes.size() || bytes.size() - e.Offsets[k] < e.Length * scalar)
+                        throw std::logic_error("Attempted to read a table whose array lies outside its file");
+            }
+
+            Bytes = bytes;
+        }
+
+        const __entry* __find(std::string_view name) const noexcept {
+            const __entry* it = std::lower_bound(Entries, Entries + Count, name, [](const __entry& e, std::string_view n) {
+                return std::string_view(e.Name) < n;
+            });
+            return it != Entries + Count && std::string_view(it->Name) == name ? it : nullptr;
+        }
+
+        template <class T>
+        const __entry& __get(std::string_view name, TableKind kind) const {
+            const __entry* e = __find(name);
+            if(e == nullptr)
+                throw std::logic_error("Attempted to read table " + std::string(name) + ", which is not in the file");
+            if(e->Kind != uint32_t(kind))
+                throw std::logic_error("Attempted to read table " + std::string(name) + " as the wrong kind");
+            if(e->Scalar != __scalar_code<T>)
+                throw std::logic_error("Attempted to read table " + std::string(name) + " as the wrong scalar type");
+            return *e;
+        }
+
+        template <class T>
+        std::span<const T> __array(const __entry& e, size_t k) const {
+            const std::byte* p = Bytes.data() + e.Offsets[k];
+            if(reinterpret_cast<uintptr_t>(p) % alignof(T) != 0)
+                throw std::logic_error("Attempted to read a table from misaligned memory");
+            return { reinterpret_cast<const T*>(p), size_t(e.Length) };
+        }
+
+        MappedFile File;
+        std::span<const std::byte> Bytes;
+        const __entry* Entries = nullptr;
+        size_t Count = 0;
+    };
+
+    /**
+     * @brief Collects tables and writes them as one file. The arrays are copied when added, so the sources
+     * may go away before writing.
+     */
+    class Writer {
+    public:
+        /// @brief Adds the coefficients without trailing zeros, as a Polynomial would hold them.
+        template <TableScalar T>
+        void AddPolynomial(std::string_view name, PolynomialView<T> p) {
+            std::span<const T> c = p.Coefficients;
+            while(!c.empty() && c.back() == T(0))
+                c = c.first(c.size() - 1);
+            __add(name, TableKind::Polynomial, __scalar_code<T>, c.size(), { std::as_bytes(c) });
+        }
+
+        template <TableScalar T, class A>
+        void AddPolynomial(std::string_view name, const Polynomial<T, A>& p) {
+            AddPolynomial(name, PolynomialView<T>(p));
+        }
+
+        template <TableScalar T>
+        void AddBarycentric(std::string_view name, const Interpolator::Lagrange::BarycentricView<T>& b) {
+            __add(name, TableKind::Barycentric, __scalar_code<T>, b.Size(), { std::as_bytes(b.X), std::as_bytes(b.Y), std::as_bytes(b.Weights) });
+        }
+
+        /// @brief Adds the nodes with their barycentric weights, computed here once.
+        template <TableScalar T, class A>
+        void AddBarycentric(std::string_view name, const std::vector<std::pair<T, T>, A>& points) {
+            std::vector<T> xs, ys;
+            xs.reserve(points.size()), ys.reserve(points.size());
+            for(const auto& [x, y] : points)
+                xs.push_back(x), ys.push_back(y);
+
+            const auto weights = Interpolator::Lagrange::ComputeBarycentricWeights(points);
+            AddBarycentric(name, Interpolator::Lagrange::BarycentricView<T>(xs, ys, std::span<const T>(weights)));
+        }
+
+        size_t Size() const noexcept {
+            return Pending.size();
+        }
+
+        /// @brief The whole file, entries sorted by name.
+        std::vector<std::byte> Serialize() const {
+            auto align_up = [](size_t n) { return (n + ArrayAlignment - 1) / ArrayAlignment * ArrayAlignment; };
+
+            size_t size = align_up(sizeof(__file_header) + Pending.size() * sizeof(__entry));
+            for(const auto& [name, t] : Pending)
+                for(const auto& a : t.Arrays)
+                    size = align_up(size + a.size());
+
+            std::vector<std::byte> res(size);
+            __file_header header {};
+            std::memcpy(header.Magic, __magic, sizeof(__magic));
+            header.Version = FormatVersion;
+            header.ByteOrder = __byte_order_mark;
+            header.EntryCount = Pending.size();
+            header.FileSize = size;
+            std::memcpy(res.data(), &header, sizeof(header));
+
+            size_t entry_offset = sizeof(__file_header);
+            size_t offset = align_up(sizeof(__file_header) + Pending.size() * sizeof(__entry));
+            for(const auto& [name, t] : Pending) {
+                __entry e {};
+                std::memcpy(e.Name, name.data(), name.size());
+                e.Kind = uint32_t(t.Kind);
+                e.Scalar = t.Scalar;
+                e.Length = t.Length;
+                for(size_t k = 0; k < t.Arrays.size(); k++) {
+                    e.Offsets[k] = offset;
+                    std::copy(t.Arrays[k].begin(), t.Arrays[k].end(), res.begin() + offset);
+                    offset = align_up(offset + t.Arrays[k].size());
+                }
+
+                std::memcpy(res.data() + entry_offset, &e, sizeof(e));
+                entry_offset += sizeof(e);
+            }
+
+            return res;
+        }
+
+        /// @brief Writes the file next to path and renames it into place, so readers mapping the old file
+        /// keep a consistent copy and never see a partial one.
+        void Write(const std::string& path) const {
+            const auto bytes = Serialize();
+            const std::string temp = path + ".tmp";
+
+            std::FILE* out = std::fopen(temp.c_str(), "wb");
+            if(out == nullptr)
+                throw std::system_error(errno, std::generic_category(), "Attempted to create " + temp);
+
+            const bool written = std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+            if(std::fclose(out) != 0 || !written) {
+                const int err = errno;
+                std::remove(temp.c_str());
+                throw std::system_error(err, std::generic_category(), "Attempted to write " + temp);
+            }
+            if(std::rename(temp.c_str(), path.c_str()) != 0) {
+                const int err = errno;
+                std::remove(temp.c_str());
+                throw std::system_error(err, std::generic_category(), "Attempted to replace " + path);
+            }
+        }
+
+    private:
+        struct __table {
+            TableKind Kind;
+            uint32_t Scalar;
+            size_t Length;
+            std::vector<std::vector<std::byte>> Arrays;
+        };
+
+        void __add(std::string_view name, TableKind kind, uint32_t scalar, size_t length, std::initializer_list<std::span<const std::byte>> arrays) {
+            if(name.empty() || name.size() >= sizeof(__entry::Name) || name.find('\0') != std::string_view::npos)
+                throw std::logic_error("Attempted to add a table whose name is empty, has a NUL or is longer than 63 bytes");
+
+            __table t { kind, scalar, length, {} };
+            for(auto a : arrays)
+                t.Arrays.emplace_back(a.begin(), a.end());
+
+            if(!Pending.emplace(std::string(name), std::move(t)).second)
+                throw std::logic_error("Attempted to add table " + std::string(name) + " twice");
+        }
+
+        std::map<std::string, __table, std::less<>> Pending;
+    };
+};
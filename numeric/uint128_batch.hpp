@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "uint128_t.hpp"
+
+// Array-level uint128_t kernels. Vector paths load consecutive values, split them into a register of low
+// words and a register of high words (SoA), carry between the two with unsigned lane compares, and
+// interleave them back on store. The vector paths assume little-endian words, as every x86 target has.
+
+#if defined(__AVX2__)
+// Four consecutive values as SoA registers; the lanes hold elements 0, 2, 1, 3
+inline void __u128x4_load(const uint128_t* p, __m256i& lo, __m256i& hi) noexcept {
+    const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 2));
+    lo = _mm256_unpacklo_epi64(v0, v1), hi = _mm256_unpackhi_epi64(v0, v1);
+}
+
+inline void __u128x4_store(uint128_t* p, __m256i lo, __m256i hi) noexcept {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm256_unpacklo_epi64(lo, hi));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 2), _mm256_unpackhi_epi64(lo, hi));
+}
+
+// All-ones where a < b as unsigned 64-bit lanes; AVX2 only compares signed, so flip the sign bits first
+inline __m256i __u64x4_less(__m256i a, __m256i b) noexcept {
+    const __m256i s = _mm256_set1_epi64x(INT64_MIN);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(b, s), _mm256_xor_si256(a, s));
+}
+#endif
+
+#if defined(__AVX512F__)
+// Eight consecutive values as SoA registers; the lanes hold elements 0, 4, 1, 5, 2, 6, 3, 7.
+// The zero-masked unpacks with every lane selected are the plain ones, minus the undefined pass-through
+// operand that GCC reports as maybe-uninitialized.
+inline void __u128x8_load(const uint128_t* p, __m512i& lo, __m512i& hi) noexcept {
+    const __m512i v0 = _mm512_loadu_si512(p), v1 = _mm512_loadu_si512(p + 4);
+    lo = _mm512_maskz_unpacklo_epi64(0xff, v0, v1), hi = _mm512_maskz_unpackhi_epi64(0xff, v0, v1);
+}
+
+inline void __u128x8_store(uint128_t* p, __m512i lo, __m512i hi) noexcept {
+    _mm512_storeu_si512(p, _mm512_maskz_unpacklo_epi64(0xff, lo, hi));
+    _mm512_storeu_si512(p + 4, _mm512_maskz_unpackhi_epi64(0xff, lo, hi));
+}
+#endif
+
+namespace Batch {
+    constexpr void __check_sizes(size_t a, size_t b, size_t out) {
+        if(a != b || out != a)
+            throw std::logic_error("Attempted to combine uint128_t arrays of different lengths");
+    }
+
+    /// @brief out[i] = a[i] + b[i] modulo 2^128. `out` may alias either input.
+    constexpr void Add(std::span<const uint128_t> a, std::span<const uint128_t> b, std::span<uint128_t> out) {
+        __check_sizes(a.size(), b.size(), out.size());
+        size_t i = 0;
+        if(!std::is_constant_evaluated()) {
+#if defined(__AVX512F__)
+            const __m512i one = _mm512_set1_epi64(1);
+            for(; i + 8 <= a.size(); i += 8) {
+                __m512i al, ah, bl, bh;
+                __u128x8_load(&a[i], al, ah), __u128x8_load(&b[i], bl, bh);
+                const __m512i lo = _mm512_add_epi64(al, bl);
+                const __m512i hi = _mm512_add_epi64(ah, bh);
+                __u128x8_store(&out[i], lo, _mm512_mask_add_epi64(hi, _mm512_cmplt_epu64_mask(lo, al), hi, one));
+            }
+#endif
+#if defined(__AVX2__)
+            for(; i + 4 <= a.size(); i += 4) {
+                __m256i al, ah, bl, bh;
+                __u128x4_load(&a[i], al, ah), __u128x4_load(&b[i], bl, bh);
+                const __m256i lo = _mm256_add_epi64(al, bl);
+                // The carry mask is -1, so subtracting it adds the carry
+                const __m256i hi = _mm256_sub_epi64(_mm256_add_epi64(ah, bh), __u64x4_less(lo, al));
+                __u128x4_store(&out[i], lo, hi);
+            }
+#endif
+        }
+        for(; i < a.size(); i++)
+            out[i] = a[i] + b[i];
+    }
+
+    /// @brief out[i] = a[i] - b[i] modulo 2^128. `out` may alias either input.
+    constexpr void Sub(std::span<const uint128_t> a, std::span<const uint128_t> b, std::span<uint128_t> out) {
+        __check_sizes(a.size(), b.size(), out.size());
+        size_t i = 0;
+        if(!std::is_constant_evaluated()) {
+#if defined(__AVX512F__)
+            const __m512i one = _mm512_set1_epi64(1);
+            for(; i + 8 <= a.size(); i += 8) {
+                __m512i al, ah, bl, bh;
+                __u128x8_load(&a[i], al, ah), __u128x8_load(&b[i], bl, bh);
+                const __m512i hi = _mm512_sub_epi64(ah, bh);
+                __u128x8_store(&out[i], _mm512_sub_epi64(al, bl), _mm512_mask_sub_epi64(hi, _mm512_cmplt_epu64_mask(al, bl), hi, one));
+            }
+#endif
+#if defined(__AVX2__)
+            for(; i + 4 <= a.size(); i += 4) {
+                __m256i al, ah, bl, bh;
+                __u128x4_load(&a[i], al, ah), __u128x4_load(&b[i], bl, bh);
+                const __m256i hi = _mm256_add_epi64(_mm256_sub_epi64(ah, bh), __u64x4_less(al, bl));
+                __u128x4_store(&out[i], _mm256_sub_epi64(al, bl), hi);
+            }
+#endif
+        }
+        for(; i < a.size(); i++)
+            out[i] = a[i] - b[i];
+    }
+
+    /**
+     * @brief out[i] = a[i] * m[i] modulo 2^128. `out` may alias `a`.
+     * @note Neither AVX2 nor AVX-512F has a 64x64->128 lane multiply, and emulating one from 32-bit
+     * products costs more than `mulx`, so this is a scalar loop of one wide and one low product each.
+     */
+    constexpr void Mul(std::span<const uint128_t> a, std::span<const uint64_t> m, std::span<uint128_t> out) {
+        __check_sizes(a.size(), m.size(), out.size());
+        for(size_t i = 0; i < a.size(); i++) {
+            uint128_t r = __umul128(a[i].Lo(), m[i]);
+            out[i] = r += uint128_t(a[i].Hi() * m[i], 0);
+        }
+    }
+
+    /// @brief out[i] = a[i] * m modulo 2^128, e.g. to rescale fixed-point values. `out` may alias `a`.
+    constexpr void Mul(std::span<const uint128_t> a, uint64_t m, std::span<uint128_t> out) {
+        __check_sizes(a.size(), a.size(), out.size());
+        for(size_t i = 0; i < a.size(); i++) {
+            uint128_t r = __umul128(a[i].Lo(), m);
+            out[i] = r += uint128_t(a[i].Hi() * m, 0);
+        }
+    }
+
+    /// @brief out[i] = -1, 0 or 1 as a[i] is less than, equal to or greater than b[i].
+    constexpr void Compare(std::span<const uint128_t> a, std::span<const uint128_t> b, std::span<int8_t> out) {
+        __check_sizes(a.size(), b.size(), out.size());
+        size_t i = 0;
+        if(!std::is_constant_evaluated()) {
+#if defined(__AVX512F__)
+            constexpr size_t order8[8] = { 0, 4, 1, 5, 2, 6, 3, 7 };
+            for(; i + 8 <= a.size(); i += 8) {
+                __m512i al, ah, bl, bh;
+                __u128x8_load(&a[i], al, ah), __u128x8_load(&b[i], bl, bh);
+                const __mmask8 eq = _mm512_cmpeq_epu64_mask(ah, bh);
+                const __mmask8 lt = _mm512_cmplt_epu64_mask(ah, bh) | (eq & _mm512_cmplt_epu64_mask(al, bl));
+                const __mmask8 gt = _mm512_cmpgt_epu64_mask(ah, bh) | (eq & _mm512_cmpgt_epu64_mask(al, bl));
+                for(size_t l = 0; l < 8; l++)
+                    out[i + order8[l]] = int8_t(((gt >> l) & 1) - ((lt >> l) & 1));
+            }
+#endif
+#if defined(__AVX2__)
+            constexpr size_t order4[4] = { 0, 2, 1, 3 };
+            for(; i + 4 <= a.size(); i += 4) {
+                __m256i al, ah, bl, bh;
+                __u128x4_load(&a[i], al, ah), __u128x4_load(&b[i], bl, bh);
+                const __m256i eq = _mm256_cmpeq_epi64(ah, bh);
+                const __m256i lt = _mm256_or_si256(__u64x4_less(ah, bh), _mm256_and_si256(eq, __u64x4_less(al, bl)));
+                const __m256i gt = _mm256_or_si256(__u64x4_less(bh, ah), _mm256_and_si256(eq, __u64x4_less(bl, al)));
+                const int lt_bits = _mm256_movemask_pd(_mm256_castsi256_pd(lt));
+                const int gt_bits = _mm256_movemask_pd(_mm256_castsi256_pd(gt));
+                for(size_t l = 0; l < 4; l++)
+                    out[i + order4[l]] = int8_t(((gt_bits >> l) & 1) - ((lt_bits >> l) & 1));
+            }
+#endif
+        }
+        for(; i < a.size(); i++)
+            out[i] = int8_t(a[i] < b[i] ? -1 : (b[i] < a[i] ? 1 : 0));
+    }
+
+    /// @brief The sum of all values modulo 2^128, e.g. a checksum or an exact fixed-point total.
+    constexpr uint128_t Sum(std::span<const uint128_t> a) noexcept {
+        uint128_t res = 0;
+        size_t i = 0;
+        if(!std::is_constant_evaluated()) {
+#if defined(__AVX512F__)
+            if(a.size() >= 8) {
+                const __m512i one = _mm512_set1_epi64(1);
+                __m512i acc_lo = _mm512_setzero_si512(), acc_hi = _mm512_setzero_si512();
+                for(; i + 8 <= a.size(); i += 8) {
+                    __m512i l, h;
+                    __u128x8_load(&a[i], l, h);
+                    acc_lo = _mm512_add_epi64(acc_lo, l);
+                    acc_hi = _mm512_add_epi64(acc_hi, h);
+                    acc_hi = _mm512_mask_add_epi64(acc_hi, _mm512_cmplt_epu64_mask(acc_lo, l), acc_hi, one);
+                }
+                alignas(64) uint64_t lo[8], hi[8];
+                _mm512_store_si512(lo, acc_lo), _mm512_store_si512(hi, acc_hi);
+                for(size_t l = 0; l < 8; l++)
+                    res += uint128_t(hi[l], lo[l]);
+            }
+#endif
+#if defined(__AVX2__)
+            if(a.size() - i >= 4) {
+                __m256i acc_lo = _mm256_setzero_si256(), acc_hi = _mm256_setzero_si256();
+                for(; i + 4 <= a.size(); i += 4) {
+                    __m256i l, h;
+                    __u128x4_load(&a[i], l, h);
+                    acc_lo = _mm256_add_epi64(acc_lo, l);
+                    acc_hi = _mm256_sub_epi64(_mm256_add_epi64(acc_hi, h), __u64x4_less(acc_lo, l));
+                }
+                alignas(32) uint64_t lo[4], hi[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lo), acc_lo), _mm256_store_si256(reinterpret_cast<__m256i*>(hi), acc_hi);
+                for(size_t l = 0; l < 4; l++)
+                    res += uint128_t(hi[l], lo[l]);
+            }
+#endif
+        }
+        for(; i < a.size(); i++)
+            res += a[i];
+        return res;
+    }
+
+    /**
+     * @brief Inclusive running sums modulo 2^128: out[i] = a[0] + ... + a[i]. `out` may alias `a`.
+     * @note Each sum depends on the previous carry, so this is a single add/adc chain rather than a
+     * vector loop; it already runs at about one element per cycle.
+     */
+    constexpr void PrefixSum(std::span<const uint128_t> a, std::span<uint128_t> out) {
+        __check_sizes(a.size(), a.size(), out.size());
+        uint128_t acc = 0;
+        for(size_t i = 0; i < a.size(); i++)
+            out[i] = acc += a[i];
+    }
+};
@@ -2,8 +2,26 @@
 
 #include <array>
 #include <bit>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <type_traits>
+
+#include "other/Instrument.hpp"
+
+// Runtime paths dispatch to the compiler's 128-bit integer when it has one; constant evaluation
+// always takes the portable paths below.
+#if defined(__SIZEOF_INT128__)
+    #define __UINT128_HAS_NATIVE 1
+#else
+    #define __UINT128_HAS_NATIVE 0
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define __UINT128_HAS_DIVQ 1
+#else
+    #define __UINT128_HAS_DIVQ 0
+#endif
 
 constexpr bool __UseLittleEndian = []() {
     uint16_t _test = 1;
@@ -19,6 +37,18 @@ struct uint128_t {
 public:
     constexpr uint128_t() noexcept { _Words[0] = 0, _Words[1] = 0; };
     constexpr uint128_t(uint64_t x) noexcept { _Hi() = 0, _Lo() = x; }
+    constexpr uint128_t(uint64_t hi, uint64_t lo) noexcept { _Hi() = hi, _Lo() = lo; }
+
+#if __UINT128_HAS_NATIVE
+    template <std::same_as<unsigned __int128> U>
+    constexpr explicit uint128_t(U x) noexcept { _Hi() = uint64_t(x >> 64), _Lo() = uint64_t(x); }
+    constexpr explicit operator unsigned __int128() const noexcept { return (unsigned __int128)(Hi()) << 64 | Lo(); }
+#endif
+
+    constexpr explicit operator uint64_t() const noexcept { return Lo(); }
+
+    constexpr uint64_t Lo() const noexcept { return __UseLittleEndian ? _Words[0] : _Words[1]; }
+    constexpr uint64_t Hi() const noexcept { return __UseLittleEndian ? _Words[1] : _Words[0]; }
 
     friend constexpr uint128_t __umul128(uint64_t a, uint64_t b) noexcept;
 
@@ -47,6 +77,12 @@ private:
 constexpr uint128_t __umul128(uint64_t a, uint64_t b) noexcept {
     using u128 = uint128_t;
 
+#if __UINT128_HAS_NATIVE
+    // A single mul/mulx instead of four partial products
+    if(!std::is_constant_evaluated())
+        return u128((unsigned __int128)a * b);
+#endif
+
     uint64_t a_lo = a & 0x00000000ffffffff, a_hi = a >> 32;
     uint64_t b_lo = b & 0x00000000ffffffff, b_hi = b >> 32;
 
@@ -61,6 +97,46 @@ constexpr uint128_t __umul128(uint64_t a, uint64_t b) noexcept {
     return res;
 }
 
+/**
+ * @brief Divide the 128-bit value `(hi, lo)` by `d`, returning the quotient and storing the remainder.
+ * @note Requires `hi < d`, so that the quotient fits in 64 bits.
+ */
+constexpr uint64_t __udiv128by64(uint64_t hi, uint64_t lo, uint64_t d, uint64_t& rem) noexcept {
+#if __UINT128_HAS_DIVQ
+    if(!std::is_constant_evaluated()) {
+        uint64_t q;
+        __asm__("divq %[d]" : "=a"(q), "=d"(rem) : [d] "r"(d), "a"(lo), "d"(hi));
+        return q;
+    }
+#endif
+
+    // Knuth's algorithm D with two 32-bit digits (Hacker's Delight, divlu)
+    constexpr uint64_t b = uint64_t(1) << 32;
+    const int s = std::countl_zero(d);
+    d <<= s;
+    const uint64_t vn1 = d >> 32, vn0 = d & 0xffffffff;
+    const uint64_t un32 = s == 0 ? hi : (hi << s) | (lo >> (64 - s));
+    const uint64_t un10 = lo << s;
+    const uint64_t un1 = un10 >> 32, un0 = un10 & 0xffffffff;
+
+    uint64_t q1 = un32 / vn1, rhat = un32 - q1 * vn1;
+    while(q1 >= b || q1 * vn0 > b * rhat + un1) {
+        q1--, rhat += vn1;
+        if(rhat >= b) break;
+    }
+
+    const uint64_t un21 = un32 * b + un1 - q1 * d;
+    uint64_t q0 = un21 / vn1;
+    rhat = un21 - q0 * vn1;
+    while(q0 >= b || q0 * vn0 > b * rhat + un0) {
+        q0--, rhat += vn1;
+        if(rhat >= b) break;
+    }
+
+    rem = (un21 * b + un0 - q0 * d) >> s;
+    return q1 * b + q0;
+}
+
 constexpr bool operator==(uint128_t a, uint128_t b) noexcept {
     return a._Lo() == b._Lo() && a._Hi() == b._Hi();
 }
@@ -77,12 +153,14 @@ constexpr uint128_t& operator+=(uint128_t& a, uint128_t b) noexcept {
 }
 
 constexpr uint128_t& operator-=(uint128_t& a, uint128_t b) noexcept {
-    bool borrow = (a._Lo() -= b._Lo()) > b._Lo();
+    const uint64_t a_lo = a._Lo();
+    bool borrow = (a._Lo() -= b._Lo()) > a_lo;
     a._Hi() -= (b._Hi() + uint64_t(borrow));
     return a;
 }
 
 constexpr uint128_t& operator*=(uint128_t& a, uint128_t b) noexcept {
+    __INSTRUMENT_OP("uint128_t::operator*=");
     uint64_t a_lo = a._Lo();
 
     a._Hi() = a._Lo() * b._Hi() + a._Hi() * b._Lo();
@@ -90,13 +168,61 @@ constexpr uint128_t& operator*=(uint128_t& a, uint128_t b) noexcept {
     return a += __umul128(a_lo, b._Lo());
 }
 
-/// TODO: Implement 128-bit unsigned integer division
+/// @brief Portable 128-by-128 division, storing the remainder in `rem`. Dividing by zero is undefined, as for built-in integers.
+constexpr uint128_t __udiv128_portable(uint128_t a, uint128_t b, uint128_t& rem) noexcept {
+    if(a < b) {
+        rem = a;
+        return uint128_t(0);
+    }
+
+    // 64-bit divisor: at most two 128/64 steps
+    if(b.Hi() == 0) {
+        uint64_t r = 0;
+        const uint64_t q_hi = a.Hi() / b.Lo();
+        const uint64_t q_lo = __udiv128by64(a.Hi() % b.Lo(), a.Lo(), b.Lo(), r);
+        rem = uint128_t(r);
+        return uint128_t(q_hi, q_lo);
+    }
+
+    // The quotient fits in 64 bits; estimate it from the normalised top word of b (Hacker's Delight, 9-3)
+    const size_t n = std::countl_zero(b.Hi());
+    uint128_t v = b, u = a;
+    v <<= n, u >>= 1;
+
+    uint64_t r = 0;
+    uint64_t q = __udiv128by64(u.Hi(), u.Lo(), v.Hi(), r);
+    q >>= 63 - n;
+    if(q != 0) q--;
+
+    uint128_t prod = b;
+    prod *= uint128_t(q);
+    rem = a;
+    rem -= prod;
+    if(rem >= b)
+        rem -= b, q++;
+
+    return uint128_t(q);
+}
+
 constexpr uint128_t& operator/=(uint128_t& a, uint128_t b) noexcept {
-    return a;
+    __INSTRUMENT_OP("uint128_t::operator/=");
+#if __UINT128_HAS_NATIVE
+    if(!std::is_constant_evaluated())
+        return a = uint128_t((unsigned __int128)(a) / (unsigned __int128)(b));
+#endif
+
+    uint128_t rem;
+    return a = __udiv128_portable(a, b, rem);
 }
 
-/// TODO: Implement 128-bit unsigned integer division remainder
 constexpr uint128_t& operator%=(uint128_t& a, uint128_t b) noexcept {
+    __INSTRUMENT_OP("uint128_t::operator%=");
+#if __UINT128_HAS_NATIVE
+    if(!std::is_constant_evaluated())
+        return a = uint128_t((unsigned __int128)(a) % (unsigned __int128)(b));
+#endif
+
+    __udiv128_portable(a, b, a);
     return a;
 }
 
@@ -116,6 +242,8 @@ constexpr uint128_t& operator^=(uint128_t& a, uint128_t b) noexcept {
 }
 
 constexpr uint128_t& operator>>=(uint128_t& a, size_t n) noexcept {
+    if(n == 0)
+        return a;
     if(n < 64) {
         a._Lo() = (a._Lo() >> n) | (a._Hi() << (64 - n));
         a._Hi() >>= n;
@@ -129,6 +257,8 @@ constexpr uint128_t& operator>>=(uint128_t& a, size_t n) noexcept {
 }
 
 constexpr uint128_t& operator<<=(uint128_t& a, size_t n) noexcept {
+    if(n == 0)
+        return a;
     if(n < 64) {
         a._Hi() = (a._Hi() << n) | (a._Lo() >> (64 - n));
         a._Lo() <<= n;
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+/**
+ * @brief A bump-pointer memory resource: allocation is an aligned pointer increment, deallocation does
+ * nothing, and Reset() reclaims everything at once while keeping the largest chunk for the next round.
+ * @note Meant for one request at a time: fit, evaluate, Reset(). Not thread-safe; give each thread its own,
+ * see ThreadArena().
+ */
+class BumpArena : public std::pmr::memory_resource {
+public:
+    explicit BumpArena(size_t initial_size = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : Upstream(upstream), NextSize(std::max(initial_size, sizeof(__chunk) + 64)) {}
+
+    BumpArena(const BumpArena&) = delete;
+    BumpArena& operator=(const BumpArena&) = delete;
+
+    ~BumpArena() override {
+        __release_chunks(nullptr);
+    }
+
+    /// @brief Frees every allocation. Only the newest, largest chunk is kept, so a steady workload stops
+    /// reaching the upstream resource after its first round.
+    void Reset() noexcept {
+        __release_chunks(Chunks);
+        if(Chunks != nullptr) {
+            Cursor = reinterpret_cast<std::byte*>(Chunks + 1);
+            End = reinterpret_cast<std::byte*>(Chunks) + Chunks->Size;
+        }
+        Used = 0;
+    }
+
+    /// @brief Bytes handed out since construction or the last Reset().
+    size_t BytesUsed() const noexcept {
+        return Used;
+    }
+
+    /// @brief Bytes currently held from the upstream resource.
+    size_t Capacity() const noexcept {
+        size_t res = 0;
+        for(const __chunk* c = Chunks; c != nullptr; c = c->Prev)
+            res += c->Size;
+        return res;
+    }
+
+private:
+    struct alignas(std::max_align_t) __chunk {
+        __chunk* Prev;
+        size_t Size;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        std::byte* p = __align_up(Cursor, alignment);
+        if(Cursor == nullptr || p + bytes > End) {
+            __grow(bytes + alignment);
+            p = __align_up(Cursor, alignment);
+        }
+
+        Cursor = p + bytes;
+        Used += bytes;
+        return p;
+    }
+
+    // Individual blocks are reclaimed by Reset()
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    static std::byte* __align_up(std::byte* p, size_t alignment) noexcept {
+        const uintptr_t v = reinterpret_cast<uintptr_t>(p);
+        return p + ((alignment - v % alignment) % alignment);
+    }
+
+    // Chunks grow geometrically, so a request of any size needs O(log size) upstream calls
+    void __grow(size_t min_bytes) {
+        const size_t size = std::max(NextSize, min_bytes + sizeof(__chunk));
+        auto* chunk = static_cast<__chunk*>(Upstream->allocate(size, alignof(__chunk)));
+        chunk->Prev = Chunks;
+        chunk->Size = size;
+        Chunks = chunk;
+        Cursor = reinterpret_cast<std::byte*>(chunk + 1);
+        End = reinterpret_cast<std::byte*>(chunk) + size;
+        NextSize = size * 2;
+    }
+
+    // Returns every chunk older than keep (all of them for nullptr) to the upstream resource
+    void __release_chunks(__chunk* keep) noexcept {
+        __chunk* c = keep != nullptr ? keep->Prev : Chunks;
+        while(c != nullptr) {
+            __chunk* prev = c->Prev;
+            Upstream->deallocate(c, c->Size, alignof(__chunk));
+            c = prev;
+        }
+
+        if(keep != nullptr)
+            keep->Prev = nullptr;
+        else
+            Chunks = nullptr, Cursor = End = nullptr;
+    }
+
+    std::pmr::memory_resource* Upstream;
+    __chunk* Chunks = nullptr;
+    std::byte* Cursor = nullptr;
+    std::byte* End = nullptr;
+    size_t NextSize;
+    size_t Used = 0;
+};
+
+/// @brief This thread's arena, for per-request scratch that is Reset() when the request completes.
+inline BumpArena& ThreadArena() {
+    thread_local BumpArena arena;
+    return arena;
+}
+
+/**
+ * @brief This thread's pooling resource, for longer-lived objects that are freed one by one.
+ * @note Unsynchronised: memory from it must be released on the thread that allocated it, and before
+ * that thread exits.
+ */
+inline std::pmr::memory_resource* ThreadPoolResource() {
+    thread_local std::pmr::unsynchronized_pool_resource pool;
+    return &pool;
+}
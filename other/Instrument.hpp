@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+
+#ifndef MATHPHY_INSTRUMENT
+#define MATHPHY_INSTRUMENT 0
+#endif
+
+#if MATHPHY_INSTRUMENT
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#endif
+
+/**
+ * Opt-in counters of the calls, floating-point operations and heap allocations of each library operation.
+ *
+ * Build with MATHPHY_INSTRUMENT=1 to turn them on. Otherwise the hooks below expand to nothing, nothing is
+ * counted and Snapshot() is empty, so code reading the counters builds either way.
+ *
+ * Allocations are seen through replacement global operator new/delete, which must be defined in exactly one
+ * translation unit of the program: define MATHPHY_INSTRUMENT_DEFINE_NEW before including this header there.
+ * They are charged to the innermost instrumented operation running on the allocating thread, so work that
+ * an operation hands to pool workers is counted in its calls and flops but not its allocations.
+ */
+namespace Instrument {
+    struct OpStats {
+        const char* Name;
+        uint64_t Calls;
+        uint64_t Flops;
+        uint64_t Allocations;
+        uint64_t AllocatedBytes;
+    };
+
+    inline constexpr bool Enabled = MATHPHY_INSTRUMENT;
+};
+
+#if MATHPHY_INSTRUMENT
+
+namespace Instrument {
+    struct __op_counters {
+        const char* Name;
+        std::atomic<uint64_t> Calls = 0;
+        std::atomic<uint64_t> Flops = 0;
+        std::atomic<uint64_t> Allocations = 0;
+        std::atomic<uint64_t> AllocatedBytes = 0;
+        std::atomic<bool> Registered = false;
+        __op_counters* Next = nullptr;
+    };
+
+    // Every operation called so far, newest first. Registration pushes without locking or allocating, so it
+    // is safe from noexcept operations and from inside operator new.
+    inline std::atomic<__op_counters*> __registered_ops = nullptr;
+
+    inline void __register(__op_counters& c) noexcept {
+        if(c.Registered.exchange(true, std::memory_order_acq_rel))
+            return;
+
+        c.Next = __registered_ops.load(std::memory_order_relaxed);
+        while(!__registered_ops.compare_exchange_weak(c.Next, &c, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // A string literal usable as a template argument, so each operation name gets its own counters
+    template <size_t N>
+    struct __op_name {
+        constexpr __op_name(const char (&s)[N]) noexcept {
+            std::copy_n(s, N, Str);
+        }
+
+        char Str[N];
+    };
+
+    template <__op_name Name>
+    inline __op_counters __counters_of { Name.Str };
+
+    inline thread_local __op_counters* __current_op = nullptr;
+
+    // Counts a call of Name and makes it the operation charged for flops and allocations until it returns
+    template <__op_name Name>
+    class __op_scope {
+    public:
+        constexpr __op_scope() noexcept {
+            if(!std::is_constant_evaluated()) {
+                auto& c = __counters_of<Name>;
+                __register(c);
+                c.Calls.fetch_add(1, std::memory_order_relaxed);
+                Previous = std::exchange(__current_op, &c);
+            }
+        }
+
+        constexpr ~__op_scope() {
+            if(!std::is_constant_evaluated())
+                __current_op = Previous;
+        }
+
+        __op_scope(const __op_scope&) = delete;
+        __op_scope& operator=(const __op_scope&) = delete;
+
+    private:
+        __op_counters* Previous = nullptr;
+    };
+
+    constexpr void __add_flops(uint64_t n) noexcept {
+        if(!std::is_constant_evaluated() && __current_op != nullptr)
+            __current_op->Flops.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    inline void __count_allocation(size_t bytes) noexcept {
+        if(__current_op != nullptr) {
+            __current_op->Allocations.fetch_add(1, std::memory_order_relaxed);
+            __current_op->AllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief The counters of every operation called so far, in order of first call.
+    inline std::vector<OpStats> Snapshot() {
+        std::vector<OpStats> res;
+        for(auto* c = __registered_ops.load(std::memory_order_acquire); c != nullptr; c = c->Next)
+            res.push_back({ c->Name, c->Calls.load(std::memory_order_relaxed), c->Flops.load(std::memory_order_relaxed),
+                            c->Allocations.load(std::memory_order_relaxed), c->AllocatedBytes.load(std::memory_order_relaxed) });
+
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+
+    /// @brief Zeroes every counter. Operations running meanwhile may be partly counted.
+    inline void Reset() noexcept {
+        for(auto* c = __registered_ops.load(std::memory_order_acquire); c != nullptr; c = c->Next) {
+            c->Calls.store(0, std::memory_order_relaxed);
+            c->Flops.store(0, std::memory_order_relaxed);
+            c->Allocations.store(0, std::memory_order_relaxed);
+            c->AllocatedBytes.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+#define __INSTRUMENT_OP(name) ::Instrument::__op_scope<name> __instrument_scope
+#define __INSTRUMENT_FLOPS(n) ::Instrument::__add_flops(n)
+
+#if defined(MATHPHY_INSTRUMENT_DEFINE_NEW)
+inline void* __instrumented_alloc(size_t n, size_t alignment) {
+    Instrument::__count_allocation(n);
+    n = std::max<size_t>(n, 1);
+    void* p = alignment <= alignof(std::max_align_t) ? std::malloc(n) : std::aligned_alloc(alignment, (n + alignment - 1) / alignment * alignment);
+    if(p == nullptr)
+        throw std::bad_alloc();
+
+    return p;
+}
+
+void* operator new(size_t n) { return __instrumented_alloc(n, alignof(std::max_align_t)); }
+void* operator new[](size_t n) { return __instrumented_alloc(n, alignof(std::max_align_t)); }
+void* operator new(size_t n, std::align_val_t al) { return __instrumented_alloc(n, size_t(al)); }
+void* operator new[](size_t n, std::align_val_t al) { return __instrumented_alloc(n, size_t(al)); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+
+#else
+
+namespace Instrument {
+    inline std::vector<OpStats> Snapshot() {
+        return {};
+    }
+
+    inline void Reset() noexcept {}
+};
+
+#define __INSTRUMENT_OP(name) ((void)0)
+#define __INSTRUMENT_FLOPS(n) ((void)0)
+
+#endif
+
+namespace Instrument {
+    /// @brief Writes stats as a JSON array of objects, one per operation.
+    inline void WriteJson(std::FILE* out, const std::vector<OpStats>& stats) {
+        std::fprintf(out, "[");
+        for(size_t i = 0; i < stats.size(); i++) {
+            const auto& s = stats[i];
+            std::fprintf(out, "%s{\"name\": \"%s\", \"calls\": %llu, \"flops\": %llu, \"allocations\": %llu, \"allocated_bytes\": %llu}",
+                         i > 0 ? ", " : "", s.Name, (unsigned long long)s.Calls, (unsigned long long)s.Flops,
+                         (unsigned long long)s.Allocations, (unsigned long long)s.AllocatedBytes);
+        }
+        std::fprintf(out, "]");
+    }
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief A read-only memory mapping of a whole file. Pages are loaded by the OS on first touch and shared
+ * with every other process mapping the same file, so opening is cheap however large the file is.
+ * @note The mapping's address stays the same when a MappedFile is moved, so spans into Bytes() remain valid
+ * until the last owner is destroyed. The file should not be truncated meanwhile; replace it by renaming.
+ */
+class MappedFile {
+public:
+    MappedFile() noexcept = default;
+
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0)
+            throw std::system_error(errno, std::generic_category(), "Attempted to open " + path);
+
+        struct stat st;
+        if(::fstat(fd, &st) != 0) {
+            const int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "Attempted to read the size of " + path);
+        }
+
+        // An empty file has nothing to map, and mmap rejects a length of zero
+        Size = size_t(st.st_size);
+        if(Size > 0) {
+            void* p = ::mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(p == MAP_FAILED) {
+                const int err = errno;
+                ::close(fd);
+                throw std::system_error(err, std::generic_category(), "Attempted to map " + path);
+            }
+            Data = static_cast<const std::byte*>(p);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : Data(std::exchange(other.Data, nullptr)), Size(std::exchange(other.Size, 0)) {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if(this != &other) {
+            __unmap();
+            Data = std::exchange(other.Data, nullptr);
+            Size = std::exchange(other.Size, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        __unmap();
+    }
+
+    /// @brief The contents of the file; the start is page-aligned.
+    std::span<const std::byte> Bytes() const noexcept {
+        return { Data, Size };
+    }
+
+private:
+    void __unmap() noexcept {
+        if(Data != nullptr)
+            ::munmap(const_cast<std::byte*>(Data), Size);
+    }
+
+    const std::byte* Data = nullptr;
+    size_t Size = 0;
+};
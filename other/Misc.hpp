@@ -1,9 +1,14 @@
 #pragma once
 
 #include <array>
+#include <cmath>
 #include <concepts>
 #include <cstddef>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
+
+#include "other/Instrument.hpp"
 
 #define GL_FOLD(Ns, N, expr) []<size_t...Ns>(std::index_sequence<Ns...>){ return (expr); }(std::make_index_sequence<N>{})
 #define FOLD(Ns, N, expr) [&]<size_t...Ns>(std::index_sequence<Ns...>){ return (expr); }(std::make_index_sequence<N>{})
@@ -94,17 +99,60 @@ constexpr T Abs(T x) noexcept {
     return x >= 0 ? x : -x;
 }
 
+// x^n by binary exponentiation: O(log n) multiplications
 template <class T>
 constexpr T Pow(T x, size_t n) noexcept {
     T res = 1;
-    for(size_t i = 0; i < n; i++)
-        res = res * x;
+    while(n > 0) {
+        if(n & 1)
+            res = res * x;
+        n >>= 1;
+        if(n > 0)
+            x = x * x;
+    }
 
     return res;
 }
 
 template <class T>
 constexpr T Sqrt(T a) noexcept {
+    __INSTRUMENT_OP("Sqrt");
+    if constexpr(std::floating_point<T>) {
+        __INSTRUMENT_FLOPS(1);
+        // The hardware square root at runtime; a Newton iteration from above, which cannot cycle, when constant-evaluated
+        if(!std::is_constant_evaluated())
+            return std::sqrt(a);
+
+        if(a != a || a < 0)
+            return std::numeric_limits<T>::quiet_NaN();
+        if(a == 0 || a == std::numeric_limits<T>::infinity())
+            return a;
+
+        // Bring a into [1, 4) by exact powers of four
+        T scale = 1;
+        while(a >= T(65536.0)) a /= T(65536.0), scale *= T(256.0);
+        while(a >= T(4.0)) a /= T(4.0), scale *= T(2.0);
+        while(a < T(1.0 / 65536.0)) a *= T(65536.0), scale /= T(256.0);
+        while(a < T(1.0)) a *= T(4.0), scale /= T(2.0);
+
+        T x = a;
+        for(T next = T(0.5) * (x + a / x); next < x; next = T(0.5) * (x + a / x))
+            x = next;
+
+        // Newton stops within an ulp; settle the last bit on the exact residual |a - y^2| (Dekker's product)
+        auto residual = [a](T y) {
+            constexpr T split = T((1ull << ((std::numeric_limits<T>::digits + 1) / 2)) + 1);
+            const T c = split * y, hi = c - (c - y), lo = y - hi;
+            const T p = y * y, e = ((hi * hi - p) + T(2) * hi * lo) + lo * lo;
+            return Abs((a - p) - e);
+        };
+        constexpr T eps = std::numeric_limits<T>::epsilon();
+        for(T y : { x - (x > T(1) ? eps : eps / 2), x + (x < T(2) ? eps : 2 * eps) })
+            if(residual(y) < residual(x))
+                x = y;
+        return x * scale;
+    }
+
     if(a == 0) return T(0);
 
     T multiplier = 1.0;
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+inline size_t HardwareConcurrency() noexcept {
+    const size_t n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+// A unit of work that lives on the stack frame of whoever spawned it, which waits for it before returning
+struct __task {
+    void (*Run)(__task*) = nullptr;
+    std::atomic<bool> Done = false;
+    std::exception_ptr Error = nullptr;
+};
+
+template <class F>
+struct __closure_task : __task {
+    explicit __closure_task(F& fn) noexcept : Fn(fn) {
+        Run = [](__task* t) {
+            auto* self = static_cast<__closure_task*>(t);
+            try {
+                self->Fn();
+            }
+            catch(...) {
+                self->Error = std::current_exception();
+            }
+            self->Done.store(true, std::memory_order_release);
+        };
+    }
+
+    F& Fn;
+};
+
+/**
+ * Chase and Lev's work-stealing deque, with the C11 memory orderings of Lê, Pop, Cohen and Zappa Nardelli:
+ * the owner pushes and pops at the bottom without contention, thieves take from the top with one CAS.
+ * Arrays outgrown by the owner stay alive until the deque dies, since a thief may still be reading one.
+ */
+class __chase_lev_deque {
+public:
+    __chase_lev_deque() {
+        Arrays.push_back(std::make_unique<__array>(64));
+        Array.store(Arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    void Push(__task* task) {
+        const int64_t b = Bottom.load(std::memory_order_relaxed), t = Top.load(std::memory_order_acquire);
+        __array* a = Array.load(std::memory_order_relaxed);
+        if(b - t > int64_t(a->Capacity) - 1)
+            a = __grow(a, t, b);
+
+        // A releasing store rather than the paper's fence: the same code on x86 and ARM, and visible to TSan
+        a->Put(b, task);
+        Bottom.store(b + 1, std::memory_order_release);
+    }
+
+    __task* Pop() noexcept {
+        const int64_t b = Bottom.load(std::memory_order_relaxed) - 1;
+        __array* a = Array.load(std::memory_order_relaxed);
+        Bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = Top.load(std::memory_order_relaxed);
+
+        if(t > b) {
+            Bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        __task* task = a->Get(b);
+        if(t == b) {
+            // The last element: race the thieves for it
+            if(!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                task = nullptr;
+            Bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    __task* Steal() noexcept {
+        int64_t t = Top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = Bottom.load(std::memory_order_acquire);
+        if(t >= b)
+            return nullptr;
+
+        __task* task = Array.load(std::memory_order_acquire)->Get(t);
+        if(!Top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return task;
+    }
+
+private:
+    struct __array {
+        explicit __array(size_t capacity) : Capacity(capacity), Slots(new std::atomic<__task*>[capacity]) {}
+
+        __task* Get(int64_t i) const noexcept { return Slots[size_t(i) & (Capacity - 1)].load(std::memory_order_relaxed); }
+        void Put(int64_t i, __task* task) noexcept { Slots[size_t(i) & (Capacity - 1)].store(task, std::memory_order_relaxed); }
+
+        size_t Capacity;
+        std::unique_ptr<std::atomic<__task*>[]> Slots;
+    };
+
+    __array* __grow(__array* a, int64_t t, int64_t b) {
+        Arrays.push_back(std::make_unique<__array>(a->Capacity * 2));
+        __array* bigger = Arrays.back().get();
+        for(int64_t i = t; i < b; i++)
+            bigger->Put(i, a->Get(i));
+        Array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<int64_t> Top = 0;
+    alignas(64) std::atomic<int64_t> Bottom = 0;
+    std::atomic<__array*> Array;
+    std::vector<std::unique_ptr<__array>> Arrays;
+};
+
+/**
+ * @brief A work-stealing thread pool. Each worker owns a Chase-Lev deque and takes work from its bottom,
+ * depth first; idle workers steal from the top of the others', which holds the largest pieces of work.
+ * A thread that waits for its tasks executes other tasks meanwhile, so waiting never blocks a core and
+ * nested parallel loops cannot deadlock.
+ * @note Threads outside the pool submit through a shared queue, and also help while they wait. The caller's
+ * own thread is therefore one of the cores in use, which is why the default size is one fewer worker than
+ * there are hardware threads.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t workers = HardwareConcurrency() - 1) : Queues(workers) {
+        for(auto& q : Queues)
+            q = std::make_unique<__chase_lev_deque>();
+
+        Threads.reserve(workers);
+        for(size_t i = 0; i < workers; i++)
+            Threads.emplace_back([this, i] { __worker_loop(i); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(SleepMtx);
+            Stopping = true;
+        }
+        SleepCv.notify_all();
+        Threads.clear();
+    }
+
+    /// @brief The number of worker threads, not counting the threads that submit work.
+    size_t Size() const noexcept {
+        return Threads.size();
+    }
+
+    /// @brief Makes task available to the workers; the caller must __wait for it before it goes out of scope.
+    void __spawn(__task* task) {
+        const auto& self = __this_worker();
+        if(self.Pool == this)
+            Queues[self.Index]->Push(task);
+        else {
+            std::lock_guard lock(SharedMtx);
+            Shared.push_back(task);
+        }
+
+        Epoch.fetch_add(1, std::memory_order_seq_cst);
+        if(Sleepers.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard lock(SleepMtx);
+            SleepCv.notify_one();
+        }
+    }
+
+    /// @brief Runs other tasks until task is done, then rethrows what it threw.
+    void __wait(__task* task) {
+        for(unsigned idle = 0; !task->Done.load(std::memory_order_acquire);) {
+            if(__task* other = __find_task()) {
+                other->Run(other);
+                idle = 0;
+            }
+            else if(++idle > 64)
+                std::this_thread::yield();
+        }
+
+        if(task->Error)
+            std::rethrow_exception(task->Error);
+    }
+
+private:
+    struct __worker_context {
+        ThreadPool* Pool = nullptr;
+        size_t Index = 0;
+        uint64_t Seed = 0x9e3779b97f4a7c15ull;
+    };
+
+    static __worker_context& __this_worker() noexcept {
+        thread_local __worker_context context;
+        return context;
+    }
+
+    // Own deque first (newest, cache-hot work), then the shared queue, then a victim picked at random
+    __task* __find_task() {
+        auto& self = __this_worker();
+        const bool is_worker = self.Pool == this;
+        if(is_worker)
+            if(__task* task = Queues[self.Index]->Pop())
+                return task;
+
+        {
+            std::unique_lock lock(SharedMtx, std::try_to_lock);
+            if(lock.owns_lock() && !Shared.empty()) {
+                // Outside threads take their newest task back, so their own recursion stays depth first
+                __task* task;
+                if(is_worker)
+                    task = Shared.front(), Shared.pop_front();
+                else
+                    task = Shared.back(), Shared.pop_back();
+                return task;
+            }
+        }
+
+        if(Queues.empty())
+            return nullptr;
+
+        self.Seed ^= self.Seed << 13, self.Seed ^= self.Seed >> 7, self.Seed ^= self.Seed << 17;
+        const size_t start = size_t(self.Seed % Queues.size());
+        for(size_t k = 0; k < Queues.size(); k++) {
+            const size_t victim = (start + k) % Queues.size();
+            if(is_worker && victim == self.Index)
+                continue;
+            if(__task* task = Queues[victim]->Steal())
+                return task;
+        }
+        return nullptr;
+    }
+
+    void __worker_loop(size_t index) {
+        auto& self = __this_worker();
+        self.Pool = this, self.Index = index, self.Seed += index * 0x2545f4914f6cdd1dull;
+
+        for(;;) {
+            const uint64_t epoch = Epoch.load(std::memory_order_seq_cst);
+            if(__task* task = __find_task()) {
+                task->Run(task);
+                continue;
+            }
+
+            // Sleep until something is spawned after the scan above; Epoch and Sleepers are each written
+            // before the other is read, so either the spawner sees a sleeper or the sleeper sees the spawn
+            std::unique_lock lock(SleepMtx);
+            Sleepers.fetch_add(1, std::memory_order_seq_cst);
+            SleepCv.wait(lock, [&] { return Stopping || Epoch.load(std::memory_order_seq_cst) != epoch; });
+            Sleepers.fetch_sub(1, std::memory_order_seq_cst);
+            if(Stopping)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<__chase_lev_deque>> Queues;
+
+    std::mutex SharedMtx;
+    std::deque<__task*> Shared;
+
+    std::atomic<uint64_t> Epoch = 0;
+    std::atomic<size_t> Sleepers = 0;
+    std::mutex SleepMtx;
+    std::condition_variable SleepCv;
+    bool Stopping = false;
+
+    // Declared last, so the workers are joined before anything they use is destroyed
+    std::vector<std::jthread> Threads;
+};
+
+inline std::atomic<ThreadPool*> __injected_thread_pool = nullptr;
+
+/**
+ * @brief The pool the library's parallel paths run on: the one given to SetDefaultThreadPool, or else a
+ * pool of HardwareConcurrency() - 1 workers created on first use.
+ */
+inline ThreadPool& DefaultThreadPool() {
+    if(ThreadPool* pool = __injected_thread_pool.load(std::memory_order_acquire))
+        return *pool;
+
+    static ThreadPool pool;
+    return pool;
+}
+
+/**
+ * @brief Runs the library's parallel paths on pool, e.g. one shared with the rest of the process so that
+ * cores are not oversubscribed. nullptr restores the built-in pool. Returns the previous injected pool.
+ * @note The pool must outlive every parallel call that may use it.
+ */
+inline ThreadPool* SetDefaultThreadPool(ThreadPool* pool) noexcept {
+    return __injected_thread_pool.exchange(pool, std::memory_order_acq_rel);
+}
+
+/// @brief A grain that gives each thread of pool about eight pieces of [0, n), enough to balance uneven work.
+inline size_t DefaultGrain(const ThreadPool& pool, size_t n) noexcept {
+    return std::max<size_t>(1, n / (8 * (pool.Size() + 1)));
+}
+
+// Halve [lo, hi) until pieces have at most grain indices; the right halves are offered for stealing and the
+// left ones run here. Pieces are combined in index order, so the result does not depend on scheduling.
+template <class T, class Leaf, class Combine>
+T __split_reduce(ThreadPool& pool, size_t lo, size_t hi, size_t grain, Leaf& leaf, Combine& combine) {
+    if(hi - lo <= grain)
+        return leaf(lo, hi);
+
+    const size_t mid = lo + (hi - lo) / 2;
+    std::optional<T> right;
+    auto run_right = [&] { right.emplace(__split_reduce<T>(pool, mid, hi, grain, leaf, combine)); };
+    __closure_task<decltype(run_right)> task(run_right);
+    pool.__spawn(&task);
+
+    std::optional<T> left;
+    try {
+        left.emplace(__split_reduce<T>(pool, lo, mid, grain, leaf, combine));
+    }
+    catch(...) {
+        // The right half refers to this frame; let it finish before unwinding
+        try { pool.__wait(&task); } catch(...) {}
+        throw;
+    }
+
+    pool.__wait(&task);
+    return combine(std::move(*left), std::move(*right));
+}
+
+// The same pieces and order of combination as __split_reduce, on the calling thread alone
+template <class Leaf, class Combine>
+auto __split_reduce_serial(size_t lo, size_t hi, size_t grain, Leaf& leaf, Combine& combine) {
+    if(hi - lo <= grain)
+        return leaf(lo, hi);
+
+    const size_t mid = lo + (hi - lo) / 2;
+    auto left = __split_reduce_serial(lo, mid, grain, leaf, combine);
+    return combine(std::move(left), __split_reduce_serial(mid, hi, grain, leaf, combine));
+}
+
+/**
+ * @brief Invoke `f(i)` for every `i` in `[first, last)` on pool. The range is halved until pieces have at
+ * most `grain` indices; each piece runs serially on one thread.
+ * @note The first exception thrown by any piece is rethrown on the calling thread.
+ */
+template <class F>
+void ParallelFor(ThreadPool& pool, size_t first, size_t last, F&& f, size_t grain = 1) {
+    if(last <= first)
+        return;
+
+    grain = std::max<size_t>(grain, 1);
+    auto leaf = [&](size_t lo, size_t hi) {
+        for(size_t i = lo; i < hi; i++)
+            f(i);
+        return true;
+    };
+
+    if(pool.Size() == 0 || last - first <= grain) {
+        leaf(first, last);
+        return;
+    }
+
+    auto combine = [](bool, bool) { return true; };
+    __split_reduce<bool>(pool, first, last, grain, leaf, combine);
+}
+
+template <class F>
+void ParallelFor(size_t first, size_t last, F&& f, size_t grain = 1) {
+    ParallelFor(DefaultThreadPool(), first, last, std::forward<F>(f), grain);
+}
+
+/**
+ * @brief Reduce `map(i)` over `[first, last)` with `combine`, starting each piece of at most `grain`
+ * indices from `identity`.
+ * @note The pieces and the order in which they are combined depend only on the range and grain, so the
+ * result is the same on every run and every pool size, even for floating-point sums.
+ */
+template <class T, class Map, class Combine>
+T ParallelReduce(ThreadPool& pool, size_t first, size_t last, T identity, Map&& map, Combine&& combine, size_t grain = 1) {
+    if(last <= first)
+        return identity;
+
+    grain = std::max<size_t>(grain, 1);
+    auto leaf = [&](size_t lo, size_t hi) {
+        T acc = identity;
+        for(size_t i = lo; i < hi; i++)
+            acc = combine(std::move(acc), map(i));
+        return acc;
+    };
+
+    if(pool.Size() == 0)
+        return __split_reduce_serial(first, last, grain, leaf, combine);
+    return __split_reduce<T>(pool, first, last, grain, leaf, combine);
+}
+
+template <class T, class Map, class Combine>
+T ParallelReduce(size_t first, size_t last, T identity, Map&& map, Combine&& combine, size_t grain = 1) {
+    return ParallelReduce(DefaultThreadPool(), first, last, std::move(identity), std::forward<Map>(map), std::forward<Combine>(combine), grain);
+}
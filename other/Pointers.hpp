@@ -1,43 +1,188 @@
 #pragma once
 
+#include <atomic>
+#include <concepts>
 #include <cstddef>
+#include <memory>
+#include <new>
 #include <utility>
 
-template <class T>
+/// @brief Reference counts updated with atomic read-modify-writes, for pointers shared across threads.
+struct AtomicRefCount {
+    using Counter = std::atomic<size_t>;
+
+    static void Increment(Counter& c) noexcept { c.fetch_add(1, std::memory_order_relaxed); }
+
+    // Release so that every owner's writes happen before the destruction, acquire for whoever destroys
+    static size_t Decrement(Counter& c) noexcept { return c.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+
+    static size_t Load(const Counter& c) noexcept { return c.load(std::memory_order_acquire); }
+
+    static bool IncrementIfNonZero(Counter& c) noexcept {
+        size_t n = c.load(std::memory_order_relaxed);
+        while(n != 0)
+            if(c.compare_exchange_weak(n, n + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return true;
+        return false;
+    }
+};
+
+/// @brief Plain reference counts, for pointers that never leave one thread.
+struct NonAtomicRefCount {
+    using Counter = size_t;
+
+    static void Increment(Counter& c) noexcept { c++; }
+    static size_t Decrement(Counter& c) noexcept { return --c; }
+    static size_t Load(const Counter& c) noexcept { return c; }
+    static bool IncrementIfNonZero(Counter& c) noexcept { return c != 0 ? (c++, true) : false; }
+};
+
+template <class P>
+concept RefCountPolicy = requires(typename P::Counter& c) {
+    P::Increment(c);
+    { P::Decrement(c) } -> std::same_as<size_t>;
+    { P::Load(c) } -> std::same_as<size_t>;
+    { P::IncrementIfNonZero(c) } -> std::same_as<bool>;
+};
+
+// Strong counts the SharedPtrs. Weak counts the WeakPtrs plus one for all the SharedPtrs together,
+// so the block outlives the object for as long as anything can still observe it.
+template <RefCountPolicy Policy>
+struct __control_block {
+    typename Policy::Counter Strong{1}, Weak{1};
+
+    virtual ~__control_block() = default;
+    virtual void __destroy_object() noexcept = 0;
+
+    void __add_strong() noexcept { Policy::Increment(Strong); }
+    void __add_weak() noexcept { Policy::Increment(Weak); }
+
+    void __release_strong() noexcept {
+        if(Policy::Decrement(Strong) == 0) {
+            __destroy_object();
+            // With no WeakPtr left none can appear any more, so the last decrement can be skipped
+            if(Policy::Load(Weak) == 1)
+                delete this;
+            else
+                __release_weak();
+        }
+    }
+
+    void __release_weak() noexcept {
+        if(Policy::Decrement(Weak) == 0)
+            delete this;
+    }
+};
+
+// An object allocated on its own and handed to SharedPtr(T*)
+template <class T, RefCountPolicy Policy>
+struct __pointer_block final : __control_block<Policy> {
+    explicit __pointer_block(T* ptr) noexcept : Ptr(ptr) {}
+    void __destroy_object() noexcept override { delete Ptr; }
+
+    T* Ptr;
+};
+
+// The object stored inside its block, for MakeShared: one allocation for both
+template <class T, RefCountPolicy Policy>
+struct __inplace_block final : __control_block<Policy> {
+    template <class... Args>
+    explicit __inplace_block(Args&&... args) { ::new(static_cast<void*>(Storage)) T(std::forward<Args>(args)...); }
+    void __destroy_object() noexcept override { std::destroy_at(Get()); }
+
+    T* Get() noexcept { return std::launder(reinterpret_cast<T*>(Storage)); }
+
+    alignas(T) unsigned char Storage[sizeof(T)];
+};
+
+struct __adopt_block_t {};
+
+/**
+ * @brief Shared ownership of an object through a reference-counted control block.
+ * @note With the default AtomicRefCount, copies may be made and dropped on any threads; NonAtomicRefCount
+ * saves the locked instructions when every owner stays on one thread. Prefer MakeShared, which allocates
+ * the object and its counts together.
+ */
+template <class T, RefCountPolicy Policy = AtomicRefCount>
 class SharedPtr {
 public:
-    constexpr SharedPtr() : PtrObj(nullptr), PtrCounter(nullptr) {}
-    constexpr SharedPtr(T* ptr) : PtrObj(ptr) {
-        PtrCounter = new size_t(0);
+    constexpr SharedPtr() noexcept : PtrObj(nullptr), PtrBlock(nullptr) {}
+    constexpr SharedPtr(std::nullptr_t) noexcept : SharedPtr() {}
+
+    SharedPtr(T* ptr) : PtrObj(ptr), PtrBlock(nullptr) {
+        if(ptr == nullptr)
+            return;
+
+        try {
+            PtrBlock = new __pointer_block<T, Policy>(ptr);
+        } catch(...) {
+            delete ptr;
+            throw;
+        }
     }
 
-    constexpr SharedPtr(const SharedPtr& other) noexcept : PtrObj(other.PtrObj), PtrCounter(other.PtrCounter) {
-        if(PtrCounter != nullptr)
-            (*PtrCounter)++;
+    // Takes over one strong reference already counted in block
+    constexpr SharedPtr(__adopt_block_t, T* ptr, __control_block<Policy>* block) noexcept : PtrObj(ptr), PtrBlock(block) {}
+
+    SharedPtr(const SharedPtr& other) noexcept : PtrObj(other.PtrObj), PtrBlock(other.PtrBlock) {
+        if(PtrBlock != nullptr)
+            PtrBlock->__add_strong();
     }
 
-    constexpr SharedPtr(SharedPtr&& other) noexcept : PtrObj(std::exchange(other.PtrObj, nullptr)), PtrCounter(std::exchange(other.PtrCounter, nullptr)) {}
+    constexpr SharedPtr(SharedPtr&& other) noexcept : PtrObj(std::exchange(other.PtrObj, nullptr)), PtrBlock(std::exchange(other.PtrBlock, nullptr)) {}
 
-    constexpr bool IsNull() noexcept { 
-        return PtrCounter == nullptr; 
+    template <class U>
+    requires std::convertible_to<U*, T*>
+    SharedPtr(const SharedPtr<U, Policy>& other) noexcept : PtrObj(other.PtrObj), PtrBlock(other.PtrBlock) {
+        if(PtrBlock != nullptr)
+            PtrBlock->__add_strong();
     }
 
-    constexpr SharedPtr<T>& operator=(const SharedPtr<T>& other) noexcept {
-        PtrObj = other.PtrObj; 
-        PtrCounter = other.PtrCounter;
-        if(PtrCounter != nullptr)
-            (*PtrCounter)++;
+    template <class U>
+    requires std::convertible_to<U*, T*>
+    SharedPtr(SharedPtr<U, Policy>&& other) noexcept : PtrObj(std::exchange(other.PtrObj, nullptr)), PtrBlock(std::exchange(other.PtrBlock, nullptr)) {}
 
-        return *this;
+    ~SharedPtr() {
+        if(PtrBlock != nullptr)
+            PtrBlock->__release_strong();
     }
 
-    constexpr SharedPtr<T>& operator=(SharedPtr<T>&& other) noexcept {
-        PtrObj = std::exchange(other.PtrObj, nullptr); 
-        PtrCounter = std::exchange(other.PtrCounter, nullptr);
+    // Copy-and-swap: the old reference is dropped, and self-assignment is harmless
+    SharedPtr& operator=(const SharedPtr& other) noexcept {
+        SharedPtr(other).Swap(*this);
+        return *this;
+    }
 
+    SharedPtr& operator=(SharedPtr&& other) noexcept {
+        SharedPtr(std::move(other)).Swap(*this);
         return *this;
     }
 
+    constexpr void Swap(SharedPtr& other) noexcept {
+        std::swap(PtrObj, other.PtrObj);
+        std::swap(PtrBlock, other.PtrBlock);
+    }
+
+    void Reset() noexcept {
+        SharedPtr().Swap(*this);
+    }
+
+    constexpr bool IsNull() const noexcept {
+        return PtrObj == nullptr;
+    }
+
+    constexpr explicit operator bool() const noexcept {
+        return PtrObj != nullptr;
+    }
+
+    size_t UseCount() const noexcept {
+        return PtrBlock != nullptr ? Policy::Load(PtrBlock->Strong) : 0;
+    }
+
+    constexpr T* Get() const noexcept {
+        return PtrObj;
+    }
+
     constexpr T& operator*() {
         return *PtrObj;
     }
@@ -54,13 +199,184 @@ public:
         return PtrObj;
     }
 
-    constexpr ~SharedPtr() { 
-        if(PtrCounter) { 
-            if(*PtrCounter == 0) { delete PtrObj; delete PtrCounter; } 
-            else (*PtrCounter)--; 
-        } 
+    template <class U>
+    friend constexpr bool operator==(const SharedPtr& a, const SharedPtr<U, Policy>& b) noexcept { return a.PtrObj == b.PtrObj; }
+    friend constexpr bool operator==(const SharedPtr& a, std::nullptr_t) noexcept { return a.PtrObj == nullptr; }
+
+    T* PtrObj;
+    __control_block<Policy>* PtrBlock;
+};
+
+/// @brief Constructs a T in the same allocation as its reference counts.
+template <class T, RefCountPolicy Policy = AtomicRefCount, class... Args>
+SharedPtr<T, Policy> MakeShared(Args&&... args) {
+    auto* block = new __inplace_block<T, Policy>(std::forward<Args>(args)...);
+    return SharedPtr<T, Policy>(__adopt_block_t{}, block->Get(), block);
+}
+
+/// @brief A non-owning observer of a SharedPtr's object, which can be promoted back while the object lives.
+template <class T, RefCountPolicy Policy = AtomicRefCount>
+class WeakPtr {
+public:
+    constexpr WeakPtr() noexcept : PtrObj(nullptr), PtrBlock(nullptr) {}
+
+    WeakPtr(const SharedPtr<T, Policy>& ptr) noexcept : PtrObj(ptr.PtrObj), PtrBlock(ptr.PtrBlock) {
+        if(PtrBlock != nullptr)
+            PtrBlock->__add_weak();
+    }
+
+    WeakPtr(const WeakPtr& other) noexcept : PtrObj(other.PtrObj), PtrBlock(other.PtrBlock) {
+        if(PtrBlock != nullptr)
+            PtrBlock->__add_weak();
+    }
+
+    constexpr WeakPtr(WeakPtr&& other) noexcept : PtrObj(std::exchange(other.PtrObj, nullptr)), PtrBlock(std::exchange(other.PtrBlock, nullptr)) {}
+
+    ~WeakPtr() {
+        if(PtrBlock != nullptr)
+            PtrBlock->__release_weak();
+    }
+
+    WeakPtr& operator=(const WeakPtr& other) noexcept {
+        WeakPtr(other).Swap(*this);
+        return *this;
+    }
+
+    WeakPtr& operator=(WeakPtr&& other) noexcept {
+        WeakPtr(std::move(other)).Swap(*this);
+        return *this;
+    }
+
+    constexpr void Swap(WeakPtr& other) noexcept {
+        std::swap(PtrObj, other.PtrObj);
+        std::swap(PtrBlock, other.PtrBlock);
+    }
+
+    void Reset() noexcept {
+        WeakPtr().Swap(*this);
+    }
+
+    size_t UseCount() const noexcept {
+        return PtrBlock != nullptr ? Policy::Load(PtrBlock->Strong) : 0;
+    }
+
+    bool Expired() const noexcept {
+        return UseCount() == 0;
+    }
+
+    /// @brief A new owner of the object, or a null pointer if the last owner is already gone.
+    SharedPtr<T, Policy> Lock() const noexcept {
+        if(PtrBlock != nullptr && Policy::IncrementIfNonZero(PtrBlock->Strong))
+            return SharedPtr<T, Policy>(__adopt_block_t{}, PtrObj, PtrBlock);
+        return {};
+    }
+
+    T* PtrObj;
+    __control_block<Policy>* PtrBlock;
+};
+
+/**
+ * @brief Base for objects that carry their own reference count, shared through IntrusivePtr.
+ * @note There is no control block: the pointer is a single word and copies touch only the object's own
+ * cache line, which suits objects handed between worker threads on hot paths. The count is not copied
+ * along with the object.
+ */
+template <class Derived, RefCountPolicy Policy = AtomicRefCount>
+class RefCounted {
+public:
+    void AddRef() const noexcept {
+        Policy::Increment(Refs);
+    }
+
+    void Release() const noexcept {
+        if(Policy::Decrement(Refs) == 0)
+            delete static_cast<const Derived*>(this);
+    }
+
+    size_t RefCount() const noexcept {
+        return Policy::Load(Refs);
+    }
+
+protected:
+    RefCounted() noexcept = default;
+    RefCounted(const RefCounted&) noexcept {}
+    RefCounted& operator=(const RefCounted&) noexcept { return *this; }
+    ~RefCounted() = default;
+
+private:
+    mutable typename Policy::Counter Refs{0};
+};
+
+/// @brief Shared ownership of an object that counts its own references, see RefCounted.
+template <class T>
+class IntrusivePtr {
+public:
+    constexpr IntrusivePtr() noexcept : PtrObj(nullptr) {}
+    constexpr IntrusivePtr(std::nullptr_t) noexcept : IntrusivePtr() {}
+
+    IntrusivePtr(T* ptr) noexcept : PtrObj(ptr) {
+        if(PtrObj != nullptr)
+            PtrObj->AddRef();
+    }
+
+    IntrusivePtr(const IntrusivePtr& other) noexcept : IntrusivePtr(other.PtrObj) {}
+    constexpr IntrusivePtr(IntrusivePtr&& other) noexcept : PtrObj(std::exchange(other.PtrObj, nullptr)) {}
+
+    template <class U>
+    requires std::convertible_to<U*, T*>
+    IntrusivePtr(const IntrusivePtr<U>& other) noexcept : IntrusivePtr(static_cast<T*>(other.PtrObj)) {}
+
+    ~IntrusivePtr() {
+        if(PtrObj != nullptr)
+            PtrObj->Release();
+    }
+
+    IntrusivePtr& operator=(const IntrusivePtr& other) noexcept {
+        IntrusivePtr(other).Swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        IntrusivePtr(std::move(other)).Swap(*this);
+        return *this;
+    }
+
+    constexpr void Swap(IntrusivePtr& other) noexcept {
+        std::swap(PtrObj, other.PtrObj);
+    }
+
+    void Reset() noexcept {
+        IntrusivePtr().Swap(*this);
+    }
+
+    constexpr bool IsNull() const noexcept {
+        return PtrObj == nullptr;
+    }
+
+    constexpr explicit operator bool() const noexcept {
+        return PtrObj != nullptr;
+    }
+
+    constexpr T* Get() const noexcept {
+        return PtrObj;
+    }
+
+    constexpr T& operator*() const {
+        return *PtrObj;
     }
 
+    constexpr T* operator->() const {
+        return PtrObj;
+    }
+
+    template <class U>
+    friend constexpr bool operator==(const IntrusivePtr& a, const IntrusivePtr<U>& b) noexcept { return a.PtrObj == b.PtrObj; }
+    friend constexpr bool operator==(const IntrusivePtr& a, std::nullptr_t) noexcept { return a.PtrObj == nullptr; }
+
     T* PtrObj;
-    size_t* PtrCounter;
-};
\ No newline at end of file
+};
+
+template <class T, class... Args>
+IntrusivePtr<T> MakeIntrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
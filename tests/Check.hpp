@@ -0,0 +1,30 @@
+#pragma once
+
+// The checks shared by the tests in this directory. A failed CHECK reports its location and the test carries
+// on, so one run lists every failure; main() returns TestExitCode() for ctest to read.
+
+#include <cmath>
+#include <cstdio>
+
+inline int& __check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond) \
+    ((cond) ? (void)0 : (void)(std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond), ++__check_failures()))
+
+// |a - b| <= tol, reporting both values when it is not
+#define CHECK_NEAR(a, b, tol) [&] { \
+    const double __a = double(a), __b = double(b); \
+    if(!(std::abs(__a - __b) <= double(tol))) { \
+        std::fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s, %s) failed: %.17g vs %.17g\n", __FILE__, __LINE__, #a, #b, #tol, __a, __b); \
+        ++__check_failures(); \
+    } \
+}()
+
+inline int TestExitCode() {
+    if(__check_failures() > 0)
+        std::fprintf(stderr, "%d check(s) failed\n", __check_failures());
+    return __check_failures() > 0 ? 1 : 0;
+}
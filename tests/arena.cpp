@@ -0,0 +1,70 @@
+#include <memory_resource>
+#include <vector>
+
+#include "numeric/Interpolators.hpp"
+#include "other/Arena.hpp"
+#include "tests/Check.hpp"
+
+// Counts what reaches the upstream resource
+struct CountingResource : std::pmr::memory_resource {
+    size_t Allocations = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        Allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+int main() {
+    auto runge = [](double x) { return 1.0 / (1.0 + 25 * x * x); };
+    const auto nodes = Interpolator::CreateChebyshevNodes(runge, -1.0, 1.0, 15);
+    const auto polynomial = Interpolator::Lagrange::ComputePolynomial(nodes);
+
+    CountingResource upstream;
+    BumpArena arena(4096, &upstream);
+    size_t warm = 0;
+    for(int round = 0; round < 5; round++) {
+        {
+            const auto pmr_nodes = Interpolator::CreateChebyshevNodes(runge, -1.0, 1.0, 15, std::pmr::polymorphic_allocator<std::pair<double, double>>(&arena));
+            const auto pmr_polynomial = Interpolator::Lagrange::ComputePolynomial(pmr_nodes);
+            CHECK(pmr_polynomial.GetAllocator().resource() == &arena);
+            for(double x = -0.95; x <= 1; x += 0.05)
+                CHECK(pmr_polynomial(x) == polynomial(x));
+        }
+
+        CHECK(arena.BytesUsed() > 0 && arena.Capacity() >= arena.BytesUsed());
+        arena.Reset();
+        CHECK(arena.BytesUsed() == 0);
+
+        // After the first round the kept chunk covers the whole request
+        if(round == 0)
+            warm = upstream.Allocations;
+        CHECK(upstream.Allocations == warm);
+    }
+
+    // Alignment is honoured across chunk boundaries
+    for(size_t alignment : { 1, 8, 64, 256 }) {
+        void* p = arena.allocate(3000, alignment);
+        CHECK(reinterpret_cast<uintptr_t>(p) % alignment == 0);
+    }
+    arena.Reset();
+
+    std::pmr::vector<int> pooled(ThreadPoolResource());
+    for(int i = 0; i < 1000; i++)
+        pooled.push_back(i);
+    CHECK(pooled[999] == 999);
+
+    std::pmr::vector<int> scratch(&ThreadArena());
+    scratch.assign(100, 1);
+    CHECK(ThreadArena().BytesUsed() >= 100 * sizeof(int));
+
+    return TestExitCode();
+}
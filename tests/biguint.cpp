@@ -0,0 +1,62 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "numeric/BigUInt.hpp"
+#include "tests/Check.hpp"
+
+static std::mt19937_64 rng(42);
+
+BigUInt random_biguint(size_t limbs) {
+    std::vector<uint64_t> v(limbs);
+    for(auto& x : v)
+        x = rng();
+    if(limbs > 0)
+        v.back() |= 1ull << 63;
+    return BigUInt::FromLimbs(v.data(), v.size());
+}
+
+int main() {
+    CHECK(Factorial(25).ToString() == "15511210043330985984000000");
+    CHECK(Binomial(100, 50).ToString() == "100891344545564193334812497256");
+    CHECK(BigUInt().ToString() == "0");
+
+    // Adding a number to itself, including a carry out of the top limb
+    BigUInt x = BigUInt(1ull << 63);
+    x += x;
+    CHECK(x.ToString() == "18446744073709551616");
+    for(size_t n : { 1, 5, 64 }) {
+        BigUInt y = random_biguint(n);
+        const BigUInt doubled = y * BigUInt(2);
+        y += y;
+        CHECK(y == doubled);
+    }
+
+    const std::string digits(5000, '7');
+    CHECK(BigUInt(digits).ToString() == digits);
+
+    // Sizes on both sides of the Karatsuba, Toom-3 and Newton division thresholds
+    for(size_t n : { 1, 3, 40, 70, 200, 500, 1200 }) {
+        for(size_t m : { 1, 2, 35, 60, 130, 400, 900 }) {
+            const BigUInt a = random_biguint(n), b = random_biguint(m);
+
+            // The product against the schoolbook limb product
+            const BigUInt p = a * b;
+            std::vector<uint64_t> ref(n + m);
+            __limbs_mul_basecase(ref.data(), a.Data(), n, b.Data(), m);
+            size_t size = ref.size();
+            while(size > 0 && ref[size - 1] == 0)
+                size--;
+            CHECK(p == BigUInt::FromLimbs(ref.data(), size));
+
+            const auto [q, r] = DivMod(a, b);
+            CHECK(r < b && q * b + r == a);
+
+            const auto [q2, r2] = DivMod(p + r, b);
+            CHECK(q2 == a && r2 == r);
+        }
+    }
+
+    return TestExitCode();
+}
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "numeric/Compensated.hpp"
+#include "tests/Check.hpp"
+
+int main() {
+    std::mt19937_64 rng(1);
+    std::normal_distribution<double> normal;
+
+    // Values spanning sixty binades that cancel exactly, around one small survivor
+    const size_t n = 1000003;
+    std::vector<double> x(n), y(n);
+    for(auto& v : x)
+        v = normal(rng) * std::ldexp(1.0, int(rng() % 60) - 30);
+    std::vector<double> cancelling = x;
+    for(double v : x)
+        cancelling.push_back(-v);
+    cancelling.push_back(1e-3);
+    std::shuffle(cancelling.begin(), cancelling.end(), rng);
+
+    const double parallel = Compensated::Sum(cancelling), serial = Compensated::Sum(cancelling, false);
+    CHECK(parallel == 1e-3);
+    CHECK(std::memcmp(&parallel, &serial, sizeof(double)) == 0);
+
+    // The dot product is the correctly rounded double-double reference
+    for(auto& v : y)
+        v = normal(rng);
+    DoubleDouble reference;
+    for(size_t i = 0; i < n; i++)
+        reference += DoubleDouble(x[i]) * y[i];
+    CHECK(Compensated::Dot(x, y) == reference.Hi);
+    CHECK(Compensated::Dot(x, y) == Compensated::Dot(x, y, false));
+
+    // Norms neither overflow nor underflow
+    const std::vector<double> huge = { 1e300, 1e300, 3e300 }, tiny = { 3e-320, 4e-320 };
+    CHECK_NEAR(Compensated::Norm2(huge) / 1e300, std::sqrt(11.0), 1e-15);
+    CHECK(Compensated::Norm2(tiny) == 5e-320);
+
+    const std::vector<float> tenths(1000, 0.1f);
+    CHECK_NEAR(Compensated::Sum(tenths), 1000 * double(0.1f), 1e-4);
+
+    // Products of floats are error-free too: 4097^2 - 16785408 needs the float split, not the double one.
+    // The constant evaluation always takes Dekker's product, whether or not the target has FMA
+    static_assert([] { float e = 0; const float p = __two_prod(4097.0f, 4097.0f, e); return double(p) + e == 16785409.0; }());
+    const std::vector<float> fx = { 4097.0f, -16785408.0f }, fy = { 4097.0f, 1.0f };
+    CHECK(Compensated::Dot(fx, fy) == 1.0f);
+
+    const std::array<double, 5> small = { 1, 2, 3, 4, 5 };
+    CHECK(Compensated::Sum(small) == 15.0 && Compensated::Dot(small, small) == 55.0);
+    CHECK(Compensated::Sum(std::span<const double>(x)) == Compensated::Sum(x));
+
+    return TestExitCode();
+}
@@ -0,0 +1,56 @@
+#include <cmath>
+#include <span>
+
+#include "numeric/DiffCalculus.hpp"
+#include "tests/Check.hpp"
+
+using namespace Differentiator;
+using V3 = NVector<double, 3>;
+
+static_assert(ADiff([](Dual<double, 1> x) { return x * x * x + 2.0 * x; }, 2.0) == 14.0);
+
+int main() {
+    auto f = [](const V3& v) { return std::sin(v[0]) * std::exp(v[1]) + v[0] * v[1] * v[2] * v[2]; };
+    const V3 x = { 0.3, 0.7, 1.2 };
+    const double grad[3] = { std::cos(0.3) * std::exp(0.7) + 0.7 * 1.44, std::sin(0.3) * std::exp(0.7) + 0.3 * 1.44, 2 * 0.3 * 0.7 * 1.2 };
+
+    // Central differences beat one-sided ones; Richardson extrapolation improves both
+    for(auto [mode, tol] : { std::pair{ Central, 1e-10 }, std::pair{ Forward, 1e-7 }, std::pair{ Backward, 1e-7 } }) {
+        for(size_t richardson : { 0, 2 }) {
+            const auto g = FDGradient(f, x, { mode, richardson, mode == Central });
+            for(size_t i = 0; i < 3; i++)
+                CHECK_NEAR(g[i], grad[i], richardson > 0 ? tol * 1e-2 : tol);
+        }
+    }
+
+    // Batched functions see every stencil point at once
+    auto batch = [&](std::span<const V3> xs, std::span<double> ys) {
+        for(size_t i = 0; i < xs.size(); i++)
+            ys[i] = f(xs[i]);
+    };
+    CHECK_NEAR(FDGradient(batch, x)[0], grad[0], 1e-10);
+
+    const auto h = FDHessian(f, x, { Central, 2, true });
+    CHECK_NEAR(h[0][0], -std::sin(0.3) * std::exp(0.7), 1e-9);
+    CHECK_NEAR(h[0][1], std::cos(0.3) * std::exp(0.7) + 1.44, 1e-9);
+    CHECK_NEAR(h[1][2], 2 * 0.3 * 1.2, 1e-9);
+    CHECK_NEAR(h[2][2], 2 * 0.21, 1e-9);
+
+    const auto j = FDJacobian<2>([](const V3& v) { return NVector<double, 2>{ v[0] * v[1], v[2] * v[2] }; }, x, { Central, 1 });
+    CHECK_NEAR(j[0][0], 0.7, 1e-10);
+    CHECK_NEAR(j[0][1], 0.3, 1e-10);
+    CHECK_NEAR(j[1][2], 2.4, 1e-10);
+
+    // Automatic differentiation is exact to rounding
+    using D4 = Dual<double, 4>;
+    const auto ad = ADGradient([](const NVector<D4, 4>& v) { return v[0] * v[1] + sin(v[2]) * exp(v[3]) / v[0]; }, NVector<double, 4>{ 1.0, 2.0, 0.5, 0.1 });
+    CHECK_NEAR(ad[0], 2.0 - std::sin(0.5) * std::exp(0.1), 1e-15);
+    CHECK_NEAR(ad[1], 1.0, 1e-15);
+    CHECK_NEAR(ad[2], std::cos(0.5) * std::exp(0.1), 1e-15);
+    CHECK_NEAR(ad[3], std::sin(0.5) * std::exp(0.1), 1e-15);
+
+    const auto adj = ADJacobian<2>([](const NVector<Dual<double, 2>, 2>& v) { return NVector<Dual<double, 2>, 2>{ v[0] * v[1], Sqrt(v[0]) }; }, NVector<double, 2>{ 4.0, 3.0 });
+    CHECK(adj[0][0] == 3.0 && adj[0][1] == 4.0 && adj[1][0] == 0.25 && adj[1][1] == 0.0);
+
+    return TestExitCode();
+}
@@ -0,0 +1,57 @@
+#include <array>
+
+#include "numeric/DoubleDouble.hpp"
+#include "numeric/Matrices.hpp"
+#include "tests/Check.hpp"
+
+using DD = DoubleDouble;
+
+constexpr DD third = DD(1.0) / DD(3.0);
+static_assert(third.Hi == 1.0 / 3.0);
+static_assert((third * DD(3.0) - DD(1.0)).Hi == 0.0);
+constexpr DD root2 = Sqrt(DD(2.0));
+static_assert((root2 * root2 - DD(2.0)).Hi < 1e-30 && (root2 * root2 - DD(2.0)).Hi > -1e-30);
+
+// |a - ref| / |ref| with ref = ref_hi + ref_lo, evaluated in double-double
+double relative_error(const DD& a, const DD& ref) {
+    return Abs(((a - ref) / ref).Hi);
+}
+
+int main() {
+    const DD e = { 2.718281828459045091e+00, 1.445646891729250158e-16 };
+    const DD ln10 = { 2.302585092994045901e+00, -2.170756223382249351e-16 };
+    CHECK(relative_error(exp(DD(1.0)), e) < 1e-31);
+    CHECK(relative_error(log(DD(10.0)), ln10) < 1e-31);
+    for(double v : { 1e-5, 0.3, 7.5, -20.0, 300.0 })
+        CHECK(relative_error(log(exp(DD(v))), DD(v)) < 1e-31);
+
+    // Finite results up to the overflow threshold, whose scale 2^1024 is not itself a double
+    for(double v : { 709.0, 709.5, 709.78 }) {
+        const DD big = exp(DD(v));
+        CHECK(std::isfinite(big.Hi) && std::isfinite(big.Lo));
+        CHECK_NEAR(big.Hi / std::exp(v), 1.0, 1e-14);
+        // Compared scaled down, since products near the top of the range overflow in Dekker's split
+        const DD ln2 = { 6.931471805599452862e-01, 2.319046813846299558e-17 };
+        CHECK(relative_error(DD(std::ldexp(big.Hi, -600), std::ldexp(big.Lo, -600)), exp(DD(v) - ln2 * 600.0)) < 1e-28);
+    }
+    CHECK(std::isinf(exp(DD(709.8)).Hi));
+    CHECK(exp(DD(-744.0)).Hi > 0);
+
+    // The 5x5 Hilbert matrix: double loses three digits of its determinant, double-double none that matter
+    Matrix<DD, 5, 5> hilbert;
+    for(size_t i = 0; i < 5; i++)
+        for(size_t j = 0; j < 5; j++)
+            hilbert[i][j] = DD(1.0) / DD(double(i + j + 1));
+    CHECK(relative_error(Det(hilbert), DD(1.0) / DD(266716800000.0)) < 1e-26);
+
+    // Packed lanes agree with scalars bit for bit
+    const DoubleDoublePack<4> pack { Pack<double, 4>(std::array<double, 4>{ 0.25, 2.0, 3.0, 0.5 }) };
+    const auto roots = sqrt(pack), exps = exp(pack);
+    for(size_t i = 0; i < 4; i++) {
+        const DD root = sqrt(DD(pack.Hi[i])), ex = exp(DD(pack.Hi[i]));
+        CHECK(root.Hi == roots.Hi[i] && root.Lo == roots.Lo[i]);
+        CHECK(ex.Hi == exps.Hi[i] && ex.Lo == exps.Lo[i]);
+    }
+
+    return TestExitCode();
+}
@@ -0,0 +1,46 @@
+#include <cmath>
+
+#include "numeric/Dual.hpp"
+#include "numeric/Matrices.hpp"
+#include "numeric/Polynomial.hpp"
+#include "tests/Check.hpp"
+
+using D1 = Dual<double, 1>;
+using D2 = Dual<double, 2>;
+
+constexpr D1 constexpr_cube = [] {
+    const D1 x = D1::Variable(2.0, 0);
+    return x * x * x + 2.0 * x;
+}();
+static_assert(constexpr_cube.Value == 12.0 && constexpr_cube.Partials[0] == 14.0);
+
+int main() {
+    // Polynomials evaluate on duals through Horner's scheme
+    const Polynomial<double> p = { 1.0, 2.0, 3.0 };
+    const D1 at_two = p(D1::Variable(2.0, 0));
+    CHECK(at_two.Value == 17.0 && at_two.Partials[0] == 14.0);
+
+    // Elementary functions carry their derivatives
+    const D2 x = D2::Variable(0.5, 0), y = D2::Variable(2.0, 1);
+    const D2 f = sin(x) * exp(y) / y + Sqrt(y);
+    CHECK_NEAR(f.Value, std::sin(0.5) * std::exp(2.0) / 2.0 + std::sqrt(2.0), 1e-15);
+    CHECK_NEAR(f.Partials[0], std::cos(0.5) * std::exp(2.0) / 2.0, 1e-14);
+    CHECK_NEAR(f.Partials[1], std::sin(0.5) * std::exp(2.0) / 4.0 + 0.5 / std::sqrt(2.0), 1e-14);
+
+    // Quotients of a variable by itself have zero derivative
+    const D1 q = D1::Variable(1.5, 0);
+    CHECK_NEAR((q * q / q - q).Partials[0], 0.0, 1e-15);
+
+    // Powers: the value at 0 stays 0 for fractional exponents, with the infinite slope of the power
+    const D1 root = pow(D1::Variable(0.0, 0), 0.5);
+    CHECK(root.Value == 0.0 && std::isinf(root.Partials[0]));
+    const D1 cube = pow(D1::Variable(2.0, 0), 3.0);
+    CHECK(cube.Value == 8.0 && cube.Partials[0] == 12.0);
+
+    // Determinants differentiate through elimination: d/da det [[a, 1], [1, b]] = b
+    const Matrix<D2, 2, 2> m = { NVector<D2, 2>{ D2::Variable(2.0, 0), D2(1.0) }, NVector<D2, 2>{ D2(1.0), D2::Variable(3.0, 1) } };
+    const D2 det = Det(m);
+    CHECK(det.Value == 5.0 && det.Partials[0] == 3.0 && det.Partials[1] == 2.0);
+
+    return TestExitCode();
+}
@@ -0,0 +1,99 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "numeric/Elementary.hpp"
+#include "tests/Check.hpp"
+
+// Constant evaluation takes the double-double paths, which round correctly
+static_assert(Exp(0.0) == 1.0);
+static_assert(Exp(1.0) == 2.718281828459045);
+static_assert(Log(2.0) == 0.6931471805599453);
+static_assert(Log(10.0) == 2.302585092994046);
+static_assert(Sin(1.0) == 0.8414709848078965);
+static_assert(Cos(1.0) == 0.5403023058681398);
+static_assert(Sin(-3.0) == -0.1411200080598672);
+static_assert(Atan2(1.0, -1.0) == 2.356194490192345);
+static_assert(Atan2(-0.0, -1.0) == -3.141592653589793);
+static_assert(Exp(1.0f) == 2.7182817f);
+static_assert(Sqrt(2.0) == 1.4142135623730951);
+static_assert(Sqrt(1e-300) == 1e-150);
+static_assert(Pow(3.0, 13) == 1594323.0);
+
+// Error of got in units of the last place of the long double reference
+long double ulp_error(double got, long double ref) {
+    if((std::isnan(got) && std::isnan(ref)) || got == ref)
+        return 0;
+
+    const double r = double(ref);
+    const double ulp = r == 0 ? std::numeric_limits<double>::denorm_min() : std::nextafter(std::abs(r), INFINITY) - std::abs(r);
+    return std::abs((long double)got - ref) / ulp;
+}
+
+template <class Gen, class Kernel, class Ref>
+long double worst_ulp_error(size_t n, Gen gen, Kernel kernel, Ref ref) {
+    std::vector<double> x(n), y(n);
+    for(auto& v : x)
+        v = gen();
+    kernel(x, y);
+
+    long double worst = 0;
+    for(size_t i = 0; i < n; i++)
+        worst = std::max(worst, ulp_error(y[i], ref((long double)x[i])));
+    return worst;
+}
+
+int main() {
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> unit(0, 1);
+    const size_t n = 200000;
+
+    if constexpr(sizeof(long double) > sizeof(double)) {
+        CHECK(worst_ulp_error(n, [&] { return -745.0 + 1455.0 * unit(rng); }, [](auto& x, auto& y) { Exp(x, y); }, [](long double v) { return expl(v); }) <= 1.0);
+        CHECK(worst_ulp_error(n, [&] { return std::exp2(-1074 + 2097 * unit(rng)); }, [](auto& x, auto& y) { Log(x, y); }, [](long double v) { return logl(v); }) <= 1.0);
+        CHECK(worst_ulp_error(n, [&] { return -8e5 + 1.6e6 * unit(rng); }, [](auto& x, auto& y) { Sin(x, y); }, [](long double v) { return sinl(v); }) <= 1.0);
+        CHECK(worst_ulp_error(n, [&] { return -10 + 20 * unit(rng); }, [](auto& x, auto& y) { Cos(x, y); }, [](long double v) { return cosl(v); }) <= 1.0);
+        CHECK(worst_ulp_error(n, [&] { return std::exp2(-1074 + 2097 * unit(rng)); }, [](auto& x, auto& y) { Sqrt(x, y); }, [](long double v) { return sqrtl(v); }) <= 0.5);
+
+        std::normal_distribution<double> normal;
+        std::vector<double> y(n), x(n), out(n);
+        for(size_t i = 0; i < n; i++)
+            y[i] = normal(rng) * std::exp2(int(rng() % 40) - 20), x[i] = normal(rng) * std::exp2(int(rng() % 40) - 20);
+        Atan2(y, x, out);
+        long double worst = 0;
+        for(size_t i = 0; i < n; i++)
+            worst = std::max(worst, ulp_error(out[i], atan2l(y[i], x[i])));
+        CHECK(worst <= 1.5);
+    }
+
+    // Special arguments behave as the standard library's
+    const std::vector<double> special = { 0.0, -0.0, INFINITY, -INFINITY, NAN, 1e-310, -1.0, 709.8, -745.2, 1e300 };
+    std::vector<double> out(special.size());
+    auto same = [](double a, double b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+
+    Exp(special, out);
+    for(size_t i = 0; i < special.size(); i++)
+        CHECK(same(out[i], std::exp(special[i])));
+    Log(special, out);
+    for(size_t i = 0; i < special.size(); i++)
+        CHECK(same(out[i], std::log(special[i])));
+    Sin(special, out);
+    for(size_t i = 0; i < special.size(); i++)
+        CHECK(same(out[i], std::sin(special[i])));
+    Cos(special, out);
+    for(size_t i = 0; i < special.size(); i++)
+        CHECK(same(out[i], std::cos(special[i])));
+
+    bool threw = false;
+    try {
+        std::vector<double> shorter(3);
+        Exp(special, shorter);
+    }
+    catch(const std::logic_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    return TestExitCode();
+}
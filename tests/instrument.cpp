@@ -0,0 +1,54 @@
+// Built with MATHPHY_INSTRUMENT=1; this translation unit also provides the counting operator new.
+#define MATHPHY_INSTRUMENT_DEFINE_NEW
+
+#include <string_view>
+#include <vector>
+
+#include "numeric/Matrices.hpp"
+#include "numeric/Polynomial.hpp"
+#include "numeric/uint128_t.hpp"
+#include "other/Instrument.hpp"
+#include "tests/Check.hpp"
+
+// Instrumented operations stay usable in constant expressions
+static_assert(uint128_t(10) / uint128_t(3) == uint128_t(3));
+static_assert(Sqrt(4.0) == 2.0);
+
+Instrument::OpStats stats_of(std::string_view name) {
+    for(const auto& s : Instrument::Snapshot())
+        if(name == s.Name)
+            return s;
+    return { nullptr, 0, 0, 0, 0 };
+}
+
+int main() {
+    static_assert(Instrument::Enabled);
+    Instrument::Reset();
+
+    const Polynomial<double> p = { 1.0, 2.0, 3.0 }, q = { 1.0, 1.0 };
+    Polynomial<double> r = p;
+    __polynomial_mul(r, q);
+    CHECK(stats_of("__polynomial_mul").Calls == 1);
+    CHECK(stats_of("__polynomial_mul").Flops == 2 * 3 * 2);
+    CHECK(stats_of("__polynomial_mul").Allocations == 1);
+
+    volatile double sink = 0;
+    for(int i = 0; i < 10; i++)
+        sink = sink + p(double(i));
+    CHECK(stats_of("Polynomial::operator()").Calls == 10);
+    CHECK(stats_of("Polynomial::operator()").Flops == 10 * 4);
+    CHECK(stats_of("Polynomial::operator()").Allocations == 0);
+
+    const Matrix<double, 3, 3> m = { { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 10 } };
+    sink = sink + MatrixMul(m, m)[0][0];
+    CHECK(stats_of("MatrixMul").Calls == 1 && stats_of("MatrixMul").Flops == 2 * 27);
+
+    uint128_t x(5, 7);
+    x /= uint128_t(11);
+    CHECK(stats_of("uint128_t::operator/=").Calls == 1);
+
+    Instrument::Reset();
+    CHECK(stats_of("__polynomial_mul").Calls == 0 && stats_of("MatrixMul").Flops == 0);
+
+    return TestExitCode();
+}
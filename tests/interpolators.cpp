@@ -0,0 +1,57 @@
+#include <cmath>
+#include <memory_resource>
+
+#include "numeric/Interpolators.hpp"
+#include "other/Arena.hpp"
+#include "tests/Check.hpp"
+
+int main() {
+    auto runge = [](double x) { return 1.0 / (1.0 + 25.0 * x * x); };
+
+    const auto chebyshev = Interpolator::CreateChebyshevNodes(runge, -1.0, 1.0, 33);
+    CHECK(chebyshev.size() == 33);
+    CHECK_NEAR(chebyshev.front().first, 1.0, 1e-15);
+    CHECK_NEAR(chebyshev.back().first, -1.0, 1e-15);
+    for(const auto& [x, y] : chebyshev)
+        CHECK(y == runge(x));
+
+    const auto equidistant = Interpolator::CreateEquidistantNodes(runge, -1.0, 1.0, 11);
+    CHECK(equidistant.size() == 11 && equidistant[5].first == 0.0 && equidistant[5].second == 1.0);
+    CHECK(equidistant.front().first == -1.0 && equidistant.back().first == 1.0);
+
+    // The pool overloads sample the same nodes
+    ThreadPool pool(3);
+    CHECK(Interpolator::CreateChebyshevNodes(pool, runge, -1.0, 1.0, 33) == chebyshev);
+    CHECK(Interpolator::CreateEquidistantNodes(pool, runge, -1.0, 1.0, 11) == equidistant);
+
+    // Interpolation on Chebyshev nodes converges for the Runge function; both forms agree on a low degree
+    auto barycentric = Interpolator::Lagrange::CreateBarycentricInterpolator(chebyshev);
+    for(double x = -0.99; x < 1.0; x += 0.0173)
+        CHECK_NEAR(barycentric(x), runge(x), 2e-3);
+
+    auto cubic = [](double x) { return x * x * x - 2.0 * x + 0.5; };
+    const auto few = Interpolator::CreateEquidistantNodes(cubic, -2.0, 3.0, 6);
+    const auto lagrange = Interpolator::Lagrange::ComputePolynomial(few);
+    auto barycentric_few = Interpolator::Lagrange::CreateBarycentricInterpolator(few);
+    for(double x : { -1.7, 0.3, 2.2 })
+        CHECK_NEAR(lagrange(x), cubic(x), 1e-12), CHECK_NEAR(barycentric_few(x), cubic(x), 1e-12);
+
+    // Nodes on a memory resource keep the polynomial and the interpolator's copies on it
+    BumpArena arena;
+    const auto pmr_nodes = Interpolator::CreateChebyshevNodes(cubic, -1.0, 1.0, 8, std::pmr::polymorphic_allocator<std::pair<double, double>>(&arena));
+    const auto pmr_polynomial = Interpolator::Lagrange::ComputePolynomial(pmr_nodes);
+    CHECK(pmr_polynomial.GetAllocator().resource() == &arena);
+    CHECK_NEAR(pmr_polynomial(0.3), cubic(0.3), 1e-12);
+    CHECK(arena.BytesUsed() > 0);
+
+    bool threw = false;
+    try {
+        Interpolator::CreateEquidistantNodes(cubic, 0.0, 1.0, 1);
+    }
+    catch(const std::logic_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    return TestExitCode();
+}
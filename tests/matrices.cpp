@@ -0,0 +1,82 @@
+#include <cmath>
+#include <memory>
+#include <random>
+
+#include "numeric/Matrices.hpp"
+#include "tests/Check.hpp"
+
+constexpr double constexpr_det() {
+    Matrix<double, 3, 3> m = { { 2.0, 1.0, 0.0 }, { 1.0, 3.0, 1.0 }, { 0.0, 1.0, 4.0 } };
+    return Det(m);
+}
+static_assert(constexpr_det() == 18.0);
+
+// Elimination without threads, for comparing the parallel path against
+template <size_t N>
+double serial_det(Matrix<double, N, N> m) {
+    double res = 1.0;
+    for(size_t j = 0; j + 1 < N; j++) {
+        size_t p = j;
+        for(size_t i = j + 1; i < N; i++)
+            if(std::abs(m[i][j]) > std::abs(m[p][j]))
+                p = i;
+        if(p != j)
+            std::swap(m[p], m[j]), res = -res;
+        for(size_t i = j + 1; i < N; i++)
+            m[i] -= m[j] * (m[i][j]) / (m[j][j]);
+    }
+    for(size_t i = 0; i < N; i++)
+        res *= m[i][i];
+    return res;
+}
+
+int main() {
+    // Rectangular products sum over the shared dimension
+    const Matrix<double, 2, 3> a = { { 1.0, 2.0, 3.0 }, { 4.0, 5.0, 6.0 } };
+    const Matrix<double, 3, 2> b = { { 1.0, 0.0 }, { 0.0, 1.0 }, { 1.0, 1.0 } };
+    const auto ab = MatrixMul(a, b);
+    CHECK(ab[0][0] == 4.0 && ab[0][1] == 5.0 && ab[1][0] == 10.0 && ab[1][1] == 11.0);
+
+    const Matrix<double, 2, 2> swap = { { 0.0, 1.0 }, { 1.0, 0.0 } };
+    CHECK(Det(swap) == -1.0);
+    CHECK(Tr(swap) == 0.0);
+
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> entry(-1.0, 1.0);
+
+    // Large enough for the products and eliminations to go to the thread pool
+    ThreadPool pool(3);
+    SetDefaultThreadPool(&pool);
+    {
+        constexpr size_t n = 96;
+        auto x = std::make_unique<Matrix<double, n, n>>(), y = std::make_unique<Matrix<double, n, n>>();
+        for(size_t i = 0; i < n; i++)
+            for(size_t j = 0; j < n; j++)
+                (*x)[i][j] = entry(rng), (*y)[i][j] = entry(rng);
+
+        const auto xy = std::make_unique<Matrix<double, n, n>>(MatrixMul(*x, *y));
+        double worst = 0;
+        for(size_t i = 0; i < n; i++) {
+            for(size_t j = 0; j < n; j++) {
+                double s = 0;
+                for(size_t k = 0; k < n; k++)
+                    s += (*x)[i][k] * (*y)[k][j];
+                worst = std::max(worst, std::abs(s - (*xy)[i][j]));
+            }
+        }
+        CHECK(worst < 1e-12);
+    }
+    {
+        constexpr size_t n = 160;
+        auto m = std::make_unique<Matrix<double, n, n>>();
+        for(size_t i = 0; i < n; i++)
+            for(size_t j = 0; j < n; j++)
+                (*m)[i][j] = entry(rng) + (i == j ? 2.0 : 0.0);
+
+        const double det = Det(*m), ref = serial_det(*m);
+        CHECK(std::abs(det - ref) <= 1e-12 * std::abs(ref));
+    }
+    SetDefaultThreadPool(nullptr);
+
+    return TestExitCode();
+}
@@ -0,0 +1,65 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "numeric/Modular.hpp"
+#include "tests/Check.hpp"
+
+using namespace Modular;
+
+static_assert(IsPrime(18446744073709551557ull));
+static_assert(!IsPrime(18446744073709551559ull));
+static_assert(IsPrime(998244353) && !IsPrime(3215031751ull) && !IsPrime(1));
+static_assert(Pow(MontgomeryContext(998244353), 3, 998244352) == 1);
+
+#if __UINT128_HAS_NATIVE
+using native_t = unsigned __int128;
+
+uint64_t reference_pow(uint64_t b, uint64_t e, uint64_t m) {
+    native_t r = 1 % m, x = b % m;
+    for(; e > 0; e >>= 1) {
+        if(e & 1)
+            r = r * x % m;
+        x = x * x % m;
+    }
+    return uint64_t(r);
+}
+#endif
+
+int main() {
+    size_t primes = 0;
+    for(uint64_t n = 0; n < 1000000; n++)
+        primes += IsPrime(n);
+    CHECK(primes == 78498);
+
+#if __UINT128_HAS_NATIVE
+    std::mt19937_64 rng(1);
+    for(int i = 0; i < 100000; i++) {
+        uint64_t n = rng() >> (i % 60);
+        if(n < 2)
+            n = 3;
+        const uint64_t a = rng() % n, b = rng() % n, e = rng();
+
+        BarrettContext barrett(n);
+        CHECK(barrett.MulPlain(a, b) == uint64_t(native_t(a) * b % n));
+        CHECK(Pow(barrett, a, e) == reference_pow(a, e, n));
+
+        if(n % 2 == 1) {
+            MontgomeryContext montgomery(n);
+            CHECK(montgomery.MulPlain(a, b) == uint64_t(native_t(a) * b % n));
+            CHECK(Pow(montgomery, a, e) == reference_pow(a, e, n));
+            CHECK(montgomery.Decode(montgomery.Encode(a)) == a);
+            CHECK(montgomery.Decode(montgomery.Encode(e)) == e % n);
+        }
+    }
+
+    std::vector<uint64_t> a(1000), b(1000), out(1000);
+    for(size_t i = 0; i < a.size(); i++)
+        a[i] = rng() % 998244353, b[i] = rng() % 998244353;
+    MulBatch(MontgomeryContext(998244353), a, b, out);
+    for(size_t i = 0; i < a.size(); i++)
+        CHECK(out[i] == uint64_t(native_t(a[i]) * b[i] % 998244353));
+#endif
+
+    return TestExitCode();
+}
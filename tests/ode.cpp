@@ -0,0 +1,64 @@
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+#include "numeric/ODE.hpp"
+#include "tests/Check.hpp"
+
+using namespace Integrator::ODE;
+using V2 = NVector<double, 2>;
+
+int main() {
+    auto oscillator = [](const double&, const V2& y) { return V2{ y[1], -y[0] }; };
+
+    {
+        RK4<double, 2> rk4;
+        V2 y = { 1.0, 0.0 };
+        double t = 0;
+        rk4.Integrate(oscillator, t, y, 0.01, 628);
+        CHECK_NEAR(t, 6.28, 1e-12);
+        CHECK_NEAR(y[0], std::cos(t), 1e-10);
+    }
+    {
+        DormandPrince45<double, 2> dp(1e-10, 1e-10);
+        V2 y = { 1.0, 0.0 };
+        double t = 0, h = 0.1;
+        dp.Integrate(oscillator, t, y, 10.0, h);
+        CHECK(t == 10.0);
+        CHECK_NEAR(y[0], std::cos(10.0), 1e-8);
+        CHECK_NEAR(y[1], -std::sin(10.0), 1e-8);
+
+        // Dense output inside the last accepted step
+        DormandPrince45<double, 2> stepper(1e-8, 1e-8);
+        V2 z = { 1.0, 0.0 };
+        double tz = 0, hz = 0.5;
+        while(!stepper.Step(oscillator, tz, z, hz));
+        CHECK_NEAR(stepper.DenseOutput(tz * 0.5)[0], std::cos(tz * 0.5), 1e-8);
+    }
+    {
+        // Symplectic integrators keep the energy bounded; the fourth-order one much more tightly
+        auto acceleration = [](const NVector<double, 1>& q) { return NVector<double, 1>{ -q[0] }; };
+        VelocityVerlet<double, 1> verlet;
+        Yoshida4<double, 1> yoshida;
+        NVector<double, 1> q1 = { 1.0 }, v1 = { 0.0 }, q2 = { 1.0 }, v2 = { 0.0 };
+        for(int i = 0; i < 10000; i++)
+            verlet.Step(acceleration, q1, v1, 0.01), yoshida.Step(acceleration, q2, v2, 0.01);
+
+        CHECK_NEAR(0.5 * (q1[0] * q1[0] + v1[0] * v1[0]), 0.5, 1e-5);
+        CHECK_NEAR(0.5 * (q2[0] * q2[0] + v2[0] * v2[0]), 0.5, 1e-9);
+        CHECK_NEAR(q2[0], std::cos(100.0), 1e-6);
+    }
+    {
+        std::vector<V2> initial;
+        for(int i = 0; i < 1003; i++)
+            initial.push_back(V2{ double(i), 0.0 });
+
+        Ensemble<double, 2> ensemble(initial);
+        ensemble.Advance([](const double&, const auto& y) { return std::decay_t<decltype(y)>{ y[1], -y[0] }; }, 0.0, 0.01, 100);
+        CHECK(ensemble.Size() == 1003);
+        for(size_t i : { 0, 1, 500, 1002 })
+            CHECK_NEAR(ensemble[i][0], i * std::cos(1.0), 1e-8 * (i + 1));
+    }
+
+    return TestExitCode();
+}
@@ -0,0 +1,60 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "other/Parallel.hpp"
+#include "tests/Check.hpp"
+
+int main() {
+    double first_sum = 0;
+    for(size_t workers : { 0, 1, 3, 7 }) {
+        ThreadPool pool(workers);
+        CHECK(pool.Size() == workers);
+
+        std::vector<int> hits(100000);
+        ParallelFor(pool, 0, hits.size(), [&](size_t i) { hits[i]++; }, 64);
+        CHECK(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+
+        // The reduction tree depends on the range and grain only, so every pool gives the same bits
+        const double sum = ParallelReduce(pool, 0, 1000000, 0.0, [](size_t i) { return 1.0 / (1.0 + i); }, [](double a, double b) { return a + b; }, 1000);
+        if(workers == 0)
+            first_sum = sum;
+        CHECK(sum == first_sum);
+
+        std::atomic<size_t> nested = 0;
+        ParallelFor(pool, 0, 100, [&](size_t) { ParallelFor(pool, 0, 100, [&](size_t) { nested++; }); });
+        CHECK(nested == 10000);
+
+        bool threw = false;
+        try {
+            ParallelFor(pool, 0, 1000, [](size_t i) { if(i == 777) throw std::runtime_error("777"); }, 10);
+        }
+        catch(const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    ThreadPool injected(2);
+    CHECK(SetDefaultThreadPool(&injected) == nullptr);
+    CHECK(&DefaultThreadPool() == &injected);
+    CHECK(SetDefaultThreadPool(nullptr) == &injected);
+    CHECK(&DefaultThreadPool() != &injected);
+
+    // Threads outside the pool submitting at once
+    ThreadPool pool(4);
+    std::atomic<size_t> total = 0;
+    {
+        std::vector<std::jthread> external;
+        for(int t = 0; t < 4; t++)
+            external.emplace_back([&] {
+                for(int r = 0; r < 200; r++)
+                    total += ParallelReduce(pool, 0, 5000, size_t(0), [](size_t i) { return i; }, [](size_t a, size_t b) { return a + b; }, 50);
+            });
+    }
+    CHECK(total == size_t(4 * 200) * (4999 * 5000 / 2));
+
+    return TestExitCode();
+}
@@ -0,0 +1,91 @@
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "other/Pointers.hpp"
+#include "tests/Check.hpp"
+
+static int alive = 0;
+
+struct Base {
+    virtual ~Base() = default;
+    int Value = 0;
+};
+
+struct Derived : Base {
+    Derived(int v) { Value = v, alive++; }
+    ~Derived() override { alive--; }
+};
+
+struct ThrowsOnConstruction {
+    ThrowsOnConstruction() { throw 1; }
+};
+
+struct Node : RefCounted<Node> {
+    Node() { alive++; }
+    ~Node() { alive--; }
+};
+
+int main() {
+    {
+        SharedPtr<Derived> a = MakeShared<Derived>(3), b = new Derived(4);
+        CHECK(alive == 2 && a.UseCount() == 1);
+
+        a = b;
+        CHECK(alive == 1 && b.UseCount() == 2 && a->Value == 4);
+        a = a;
+        CHECK(b.UseCount() == 2);
+
+        WeakPtr<Derived> weak = a;
+        SharedPtr<Base> base = a;
+        CHECK(!weak.Expired() && b.UseCount() == 3 && base->Value == 4);
+
+        a.Reset(), b.Reset();
+        CHECK(alive == 1);
+        base.Reset();
+        CHECK(alive == 0 && weak.Expired() && weak.Lock().IsNull());
+    }
+    {
+        auto a = MakeShared<Derived, NonAtomicRefCount>(1);
+        WeakPtr<Derived, NonAtomicRefCount> weak = a;
+        auto locked = weak.Lock();
+        CHECK(locked.UseCount() == 2);
+        SharedPtr<Derived, NonAtomicRefCount> moved = std::move(locked);
+        CHECK(locked.IsNull() && moved.UseCount() == 2);
+    }
+    CHECK(alive == 0);
+
+    bool threw = false;
+    try {
+        MakeShared<ThrowsOnConstruction>();
+    }
+    catch(int) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Copies and weak locks from several threads leave the counts balanced
+    {
+        auto shared = MakeShared<Derived>(7);
+        WeakPtr<Derived> weak = shared;
+        std::vector<std::jthread> threads;
+        for(int t = 0; t < 4; t++) {
+            threads.emplace_back([&] {
+                for(int i = 0; i < 100000; i++) {
+                    SharedPtr<Derived> copy = shared;
+                    if(!weak.Lock())
+                        CHECK(false);
+                }
+            });
+        }
+        threads.clear();
+        CHECK(shared.UseCount() == 1);
+
+        IntrusivePtr<Node> node = MakeIntrusive<Node>(), other = node;
+        IntrusivePtr<const Node> constant = node;
+        CHECK(node->RefCount() == 3);
+    }
+    CHECK(alive == 0);
+
+    return TestExitCode();
+}
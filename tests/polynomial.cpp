@@ -0,0 +1,79 @@
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+#include "numeric/Polynomial.hpp"
+#include "other/Arena.hpp"
+#include "tests/Check.hpp"
+
+constexpr bool check_constexpr() {
+    Polynomial<double> p = { 1.0, 2.0, 3.0 }, q = { 1.0, 1.0 };
+    const auto product = p * q;
+    return product == Polynomial<double>{ 1.0, 3.0, 5.0, 3.0 } && product / q == p && (product % q).Degree() == 0 && p(2.0) == 17.0;
+}
+static_assert(check_constexpr());
+
+int main() {
+    const Polynomial<double> p = { 1.0, 2.0, 3.0 };
+
+    CHECK(p(2.0) == 17.0);
+    CHECK(p.GetFormalDerivative()(1.0) == 8.0);
+    CHECK(p + 1.0 - 2.0 == (Polynomial<double>{ 0.0, 2.0, 3.0 }));
+    CHECK((p - p).Coefficients.empty());
+    CHECK(2.0 * p == p + p);
+
+    // Division with remainder: a = q * b + r with deg r < deg b. Monic divisors keep the quotients well-conditioned.
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+    for(size_t n : { 1, 4, 17 }) {
+        for(size_t m : { 1, 3, 9 }) {
+            Polynomial<double> a, b;
+            for(size_t i = 0; i <= n; i++)
+                a.Coefficients.push_back(coefficient(rng));
+            for(size_t i = 0; i < m; i++)
+                b.Coefficients.push_back(coefficient(rng));
+            b.Coefficients.push_back(1.0);
+
+            const auto q = a / b, r = a % b;
+            CHECK(r.Degree() < b.Degree() || (n < m && r == a));
+            CHECK(q.Degree() == (n >= m ? n - m : 0));
+            for(double x : { -0.7, 0.1, 0.9 })
+                CHECK_NEAR((q * b + r)(x), a(x), 1e-9);
+        }
+    }
+
+    // Batches agree with pointwise evaluation for every split and tail length
+    ThreadPool pool(3);
+    const Polynomial<double> wide = { 0.5, -1.0, 0.25, 2.0, -0.125, 1.0 / 3.0, 0.75 };
+    for(size_t n : { 0, 1, 63, 64, 65, 10007 }) {
+        std::vector<double> xs(n), ys(n), zs(n);
+        for(auto& x : xs)
+            x = coefficient(rng);
+
+        wide.EvaluateBatch(xs, ys);
+        wide.EvaluateBatch(xs, zs, pool, 100);
+        for(size_t i = 0; i < n; i++)
+            CHECK_NEAR(ys[i], wide(xs[i]), 1e-15), CHECK(ys[i] == zs[i]);
+    }
+
+    bool threw = false;
+    try {
+        std::vector<double> xs(4), ys(3);
+        wide.EvaluateBatch(xs, ys);
+    }
+    catch(const std::logic_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Results of arithmetic stay on the resource of their left operand
+    BumpArena arena;
+    const pmr::Polynomial<double> a({ 1.0, 2.0 }, &arena), b({ 3.0, 4.0, 5.0 }, &arena);
+    CHECK((a * b).GetAllocator().resource() == &arena);
+    CHECK((a + b).GetAllocator().resource() == &arena);
+    CHECK((b / a).GetAllocator().resource() == &arena);
+    CHECK(a.GetFormalDerivative().GetAllocator().resource() == &arena);
+    CHECK((a * b)(2.0) == 5.0 * 31.0);
+
+    return TestExitCode();
+}
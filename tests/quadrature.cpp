@@ -0,0 +1,55 @@
+#include <cmath>
+#include <numbers>
+#include <span>
+
+#include "numeric/Interpolators.hpp"
+#include "numeric/Quadrature.hpp"
+#include "tests/Check.hpp"
+
+using namespace Integrator;
+
+int main() {
+    auto f = [](double x) { return std::exp(x) * std::sin(3 * x); };
+    const double exact = (std::exp(2.0) * (std::sin(6.0) - 3 * std::cos(6.0)) + 3) / 10.0;
+
+    auto r = GaussKronrod(f, 0.0, 2.0);
+    CHECK_NEAR(r.Value, exact, 1e-14);
+    CHECK(r.Error < 1e-10);
+    CHECK_NEAR(GaussKronrod(f, 0.0, 2.0, {}, G10K21).Value, exact, 1e-14);
+    CHECK_NEAR(ClenshawCurtis(f, 0.0, 2.0).Value, exact, 1e-14);
+    CHECK_NEAR(ClenshawCurtis(Interpolator::CreateChebyshevNodes(f, 0.0, 2.0, 33)), exact, 1e-12);
+
+    // Adaptive subdivision of an oscillatory integrand
+    auto oscillatory = [](double x) { return std::sin(50 * x) * std::sin(50 * x); };
+    CHECK_NEAR(GaussKronrod(oscillatory, 0.0, 3.0).Value, 1.5 - std::sin(300.0) / 200, 1e-12);
+
+    // Endpoint singularities
+    auto inverse_sqrt = [](double x) { return 1 / std::sqrt(x); };
+    CHECK_NEAR(TanhSinh(inverse_sqrt, 0.0, 1.0).Value, 2.0, 1e-13);
+    auto log_log = [](double x) { return std::log(x) * std::log(1 - x); };
+    CHECK_NEAR(TanhSinh(log_log, 0.0, 1.0).Value, 2 - std::numbers::pi * std::numbers::pi / 6, 1e-13);
+
+    auto batch = [](std::span<const double> xs, std::span<double> ys) {
+        for(size_t i = 0; i < xs.size(); i++)
+            ys[i] = xs[i] * xs[i];
+    };
+    CHECK_NEAR(GaussKronrod(batch, 0.0, 1.0).Value, 1.0 / 3.0, 1e-15);
+
+    // Serial by default, so a stateful integrand needs no synchronisation
+    size_t calls = 0;
+    auto counting = [&](double x) { calls++; return f(x); };
+    const auto counted = GaussKronrod(counting, 0.0, 2.0);
+    CHECK(calls == counted.Evaluations);
+
+    QuadratureOptions<double> parallel;
+    parallel.Parallel = true;
+    CHECK_NEAR(GaussKronrod(f, 0.0, 2.0, parallel).Value, exact, 1e-14);
+
+    // A non-integrable pole refines down to intervals that cannot be bisected, which ends the subdivision
+    parallel.MaxSubintervals = 100000;
+    auto pole = [](double x) { return 1 / std::abs(x - 0.3); };
+    const auto diverging = GaussKronrod(pole, 0.0, 1.0, parallel);
+    CHECK(diverging.Evaluations > 0 && !(diverging.Error < 1e-10));
+
+    return TestExitCode();
+}
@@ -0,0 +1,61 @@
+#include <cmath>
+#include <numbers>
+#include <span>
+#include <vector>
+
+#include "numeric/Stencil.hpp"
+#include "tests/Check.hpp"
+
+using namespace Differentiator;
+
+constexpr auto first_order = CentralStencil<double, 1, 2>;
+static_assert(first_order.Weights[0] == -0.5 && first_order.Weights[1] == 0 && first_order.Weights[2] == 0.5);
+constexpr auto second_order = CentralStencil<double, 2, 2>;
+static_assert(second_order.Weights[0] == 1 && second_order.Weights[1] == -2 && second_order.Weights[2] == 1);
+
+int main() {
+    const auto fourth = CentralStencil<double, 4, 2>;
+    const double binomial[5] = { 1, -4, 6, -4, 1 };
+    for(size_t i = 0; i < 5; i++)
+        CHECK_NEAR(fourth.Weights[i], binomial[i], 1e-12);
+
+    const auto boundary = BoundaryStencils<double, 1, 2>;
+    CHECK_NEAR(boundary.first[0].Weights[0], -1.5, 1e-15);
+    CHECK_NEAR(boundary.second[0].Weights[2], 1.5, 1e-15);
+
+    // Derivatives of a sampled sine, boundaries included
+    const size_t n = 200;
+    const double h = 2 * std::numbers::pi / (n - 1);
+    std::vector<double> y(n), d(n);
+    for(size_t i = 0; i < n; i++)
+        y[i] = std::sin(i * h);
+
+    ApplyStencil<1, 6>(std::span<const double>(y), std::span<double>(d), h);
+    for(size_t i = 0; i < n; i++)
+        CHECK_NEAR(d[i], std::cos(i * h), 1e-9);
+
+    ApplyStencil<2, 4>(std::span<const double>(y), std::span<double>(d), h);
+    for(size_t i = 0; i < n; i++)
+        CHECK_NEAR(d[i], -std::sin(i * h), 1e-6);
+
+    // Along the middle axis of a 3-D grid
+    const size_t a = 3, b = 50, c = 37;
+    const double hb = 0.1;
+    std::vector<double> g(a * b * c), dg(a * b * c);
+    for(size_t i = 0; i < a; i++)
+        for(size_t j = 0; j < b; j++)
+            for(size_t k = 0; k < c; k++)
+                g[(i * b + j) * c + k] = std::exp(0.1 * j * hb * (k + 1));
+
+    ApplyStencil<1, 4, double, 3>(g, dg, { a, b, c }, 1, hb);
+    for(size_t i = 0; i < a; i++) {
+        for(size_t j = 0; j < b; j++) {
+            for(size_t k = 0; k < c; k++) {
+                const double exact = 0.1 * (k + 1) * std::exp(0.1 * j * hb * (k + 1));
+                CHECK(std::abs(dg[(i * b + j) * c + k] - exact) <= 1e-2 * exact);
+            }
+        }
+    }
+
+    return TestExitCode();
+}
@@ -0,0 +1,101 @@
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "numeric/Tables.hpp"
+#include "tests/Check.hpp"
+
+template <class F>
+bool throws(F&& f) {
+    try {
+        f();
+    }
+    catch(const std::logic_error&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    auto f = [](double x) { return std::exp(x) * std::sin(5.0 * x); };
+    const auto nodes = Interpolator::CreateChebyshevNodes(f, -1.0, 1.0, 48);
+    auto interpolator = Interpolator::Lagrange::CreateBarycentricInterpolator(nodes);
+    const auto nodes_f = Interpolator::CreateChebyshevNodes([](float x) { return x * x; }, -1.0f, 1.0f, 9);
+    const Polynomial<double> p = { 0.5, -1.0, 0.25, 3.0 };
+    const Polynomial<DoubleDouble> p_dd = { DoubleDouble(1.0, 1e-20), DoubleDouble(2.0) };
+
+    Tables::Writer writer;
+    writer.AddBarycentric("sin", nodes);
+    writer.AddBarycentric("square", nodes_f);
+    writer.AddPolynomial("cubic", p);
+    writer.AddPolynomial("dd", p_dd);
+    const std::vector<double> padded = { 1.0, 2.0, 3.0, 0.0, 0.0 };
+    writer.AddPolynomial("padded", PolynomialView<double>(padded));
+    CHECK(throws([&] { writer.AddPolynomial("cubic", p); }));
+    CHECK(throws([&] { writer.AddPolynomial(std::string(64, 'x'), p); }));
+    CHECK(throws([&] { writer.AddPolynomial("", p); }));
+
+    const auto bytes = writer.Serialize();
+    const Tables::Reader reader(bytes);
+    CHECK(reader.Size() == 5);
+    CHECK(reader.Entry(0).Name == "cubic" && reader.Entry(4).Name == "square");
+    CHECK(reader.GetPolynomial<double>("padded").Degree() == 2 && reader.Entry(2).Length == 3);
+    CHECK(reader.Entry(3).Kind == Tables::TableKind::Barycentric && reader.Entry(3).Length == 48 && reader.Entry(3).Scalar == "double");
+    CHECK(reader.Contains("dd") && !reader.Contains("d") && !reader.Contains("sine"));
+
+    // The views read the bytes in place and evaluate bit for bit like what was written
+    const auto sin_view = reader.GetBarycentric<double>("sin");
+    CHECK(sin_view.X.data() >= reinterpret_cast<const double*>(bytes.data()) && sin_view.X.data() < reinterpret_cast<const double*>(bytes.data() + bytes.size()));
+    CHECK(reinterpret_cast<uintptr_t>(sin_view.Weights.data()) % alignof(double) == 0);
+    for(double x = -0.99; x < 1.0; x += 0.031)
+        CHECK(sin_view(x) == interpolator(x));
+
+    const auto cubic = reader.GetPolynomial<double>("cubic");
+    CHECK(cubic.Degree() == 3 && cubic.ToPolynomial() == p);
+    std::vector<double> xs = { -2.0, 0.0, 0.5, 7.0 }, ys(xs.size());
+    cubic.EvaluateBatch(xs, ys);
+    for(size_t i = 0; i < xs.size(); i++)
+        CHECK(ys[i] == p(xs[i]) && cubic(xs[i]) == p(xs[i]));
+
+    CHECK(reader.GetPolynomial<DoubleDouble>("dd")(3.0).Lo == p_dd(3.0).Lo);
+    CHECK(reader.GetBarycentric<float>("square")(0.5f) == Interpolator::Lagrange::CreateBarycentricInterpolator(nodes_f)(0.5f));
+
+    CHECK(throws([&] { reader.GetPolynomial<double>("missing"); }));
+    CHECK(throws([&] { reader.GetPolynomial<double>("sin"); }));
+    CHECK(throws([&] { reader.GetBarycentric<float>("sin"); }));
+
+    // Through a mapped file
+    const auto path = (std::filesystem::temp_directory_path() / "mathphy_tables_test.tbl").string();
+    writer.Write(path);
+    {
+        Tables::Reader mapped(path);
+        Tables::Reader moved = std::move(mapped);
+        const auto view = moved.GetBarycentric<double>("sin");
+        for(double x = -0.9; x < 1.0; x += 0.1)
+            CHECK(view(x) == interpolator(x));
+    }
+    std::filesystem::remove(path);
+
+    // Damaged files are rejected when opened; the second entry starts at 192, its kind at +64, length at +72
+    // and first array offset at +80
+    auto damaged = [&](auto change) {
+        std::vector<std::byte> copy = bytes;
+        change(copy);
+        return throws([&] { Tables::Reader r(copy); });
+    };
+    CHECK(damaged([](auto& b) { b[0] = std::byte('X'); }));
+    CHECK(damaged([](auto& b) { b[8] = std::byte(2); }));
+    CHECK(damaged([](auto& b) { b.resize(b.size() - 8); }));
+    CHECK(damaged([](auto& b) { b.resize(40); }));
+    CHECK(damaged([](auto& b) { std::memset(b.data() + 64, 'z', 64); }));
+    CHECK(damaged([](auto& b) { b[64 + 128 + 64] = std::byte(9); }));
+    CHECK(damaged([](auto& b) { b[64 + 128 + 80] = std::byte(0x20); }));
+    CHECK(damaged([](auto& b) { b[64 + 128 + 87] = std::byte(0x10); }));
+    CHECK(damaged([](auto& b) { b[64 + 128 + 79] = std::byte(0x10); }));
+    CHECK(!damaged([](auto&) {}));
+
+    return TestExitCode();
+}
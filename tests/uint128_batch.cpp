@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "numeric/uint128_batch.hpp"
+#include "tests/Check.hpp"
+
+static_assert([] {
+    uint128_t x[5] = { 1, 2, 3, 4, 5 }, y[5];
+    Batch::PrefixSum(x, y);
+    return Batch::Sum(x) == uint128_t(15) && y[4] == uint128_t(15);
+}());
+
+int main() {
+    std::mt19937_64 rng(7);
+
+    // Lengths around the vector widths exercise the tails; saturated words exercise the carries
+    for(size_t n : { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 33, 1000 }) {
+        std::vector<uint128_t> a(n), b(n), out(n);
+        std::vector<uint64_t> m(n);
+        std::vector<int8_t> cmp(n);
+        for(size_t i = 0; i < n; i++) {
+            const uint64_t hi = i % 3 == 0 ? ~0ull : rng(), lo = i % 5 == 0 ? ~0ull : rng();
+            a[i] = uint128_t(hi, lo);
+            b[i] = i % 7 == 0 ? a[i] : i % 4 == 0 ? uint128_t(hi, rng()) : uint128_t(rng(), rng());
+            m[i] = rng();
+        }
+
+        Batch::Add(a, b, out);
+        for(size_t i = 0; i < n; i++)
+            CHECK(out[i] == a[i] + b[i]);
+
+        Batch::Sub(a, b, out);
+        for(size_t i = 0; i < n; i++)
+            CHECK(out[i] == a[i] - b[i]);
+
+        Batch::Mul(a, m, out);
+        for(size_t i = 0; i < n; i++)
+            CHECK(out[i] == a[i] * uint128_t(m[i]));
+
+        Batch::Mul(a, uint64_t(0x123456789abcdefull), out);
+        for(size_t i = 0; i < n; i++)
+            CHECK(out[i] == a[i] * uint128_t(0x123456789abcdefull));
+
+        Batch::Compare(a, b, cmp);
+        for(size_t i = 0; i < n; i++)
+            CHECK(cmp[i] == (a[i] < b[i] ? -1 : a[i] == b[i] ? 0 : 1));
+
+        uint128_t sum = 0;
+        for(size_t i = 0; i < n; i++) {
+            sum += a[i];
+            CHECK(i + 1 < n || Batch::Sum(a) == sum);
+        }
+
+        Batch::PrefixSum(a, out);
+        sum = 0;
+        for(size_t i = 0; i < n; i++)
+            CHECK(out[i] == (sum += a[i]));
+
+        // In place
+        std::vector<uint128_t> c = a;
+        Batch::Add(c, b, c);
+        for(size_t i = 0; i < n; i++)
+            CHECK(c[i] == a[i] + b[i]);
+    }
+
+    return TestExitCode();
+}
@@ -0,0 +1,67 @@
+#include <cstdint>
+#include <random>
+
+#include "numeric/uint128_t.hpp"
+#include "tests/Check.hpp"
+
+// splitmix64, usable in constant evaluation
+constexpr uint64_t next_random(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// Quotients and remainders against the schoolbook identity a = q * b + r with r < b, over divisors of every width
+constexpr bool check_division(int n) {
+    uint64_t state = 42;
+    for(int i = 0; i < n; i++) {
+        uint64_t ah = next_random(state), al = next_random(state), bh = next_random(state), bl = next_random(state);
+        switch(i % 5) {
+            case 0: bh = 0; break;
+            case 1: bh = 0, bl >>= i % 63; break;
+            case 2: bh >>= i % 64; break;
+            case 3: ah = 0; break;
+            default: break;
+        }
+        if(bh == 0 && bl == 0)
+            bl = 1;
+
+        const uint128_t a(ah, al), b(bh, bl);
+        const uint128_t q = a / b, r = a % b;
+        if(!(r < b) || q * b + r != a)
+            return false;
+    }
+    return true;
+}
+
+static_assert(check_division(2000));
+static_assert(uint128_t(7) / uint128_t(2) == uint128_t(3));
+static_assert(__umul128(~0ull, ~0ull) == uint128_t(~0ull - 1, 1));
+
+int main() {
+    CHECK(check_division(200000));
+
+#if __UINT128_HAS_NATIVE
+    using native_t = unsigned __int128;
+    std::mt19937_64 rng(7);
+    for(int i = 0; i < 200000; i++) {
+        const uint64_t ah = rng(), al = rng(), bh = i % 3 == 0 ? 0 : rng() >> (i % 64), bl = rng() | 1;
+        const uint128_t a(ah, al), b(bh, bl);
+        const native_t na = native_t(ah) << 64 | al, nb = native_t(bh) << 64 | bl;
+
+        uint128_t rem;
+        const uint128_t q = __udiv128_portable(a, b, rem);
+        CHECK(native_t(q) == na / nb && native_t(rem) == na % nb);
+        CHECK(native_t(a * b) == na * nb);
+        CHECK(native_t(a + b) == na + nb && native_t(a - b) == na - nb);
+        CHECK((a < b) == (na < nb));
+
+        uint128_t l = a, r = a;
+        l <<= i % 128, r >>= i % 128;
+        CHECK(native_t(l) == na << (i % 128) && native_t(r) == na >> (i % 128));
+    }
+#endif
+
+    return TestExitCode();
+}
@@ -0,0 +1,124 @@
+// Writes table files (see numeric/Tables.hpp) from text, and lists what a table file holds.
+// Build with the CMake project (target mathphy_tables), or from the repository root:
+//     g++ -std=c++20 -O2 -I. tools/tables.cpp -o mathphy_tables -pthread
+//
+// Usage: mathphy_tables write OUT [--type=float|double] (--polynomial=NAME:FILE | --nodes=NAME:FILE)...
+//        mathphy_tables list FILE
+//
+// A polynomial FILE holds the coefficients in increasing degree; a nodes FILE holds x y pairs, such as
+// sampled offline from CreateChebyshevNodes, whose barycentric weights are computed here. Numbers are
+// separated by white space and read as double, then converted to the --type in effect, default double;
+// --type applies to the tables after it.
+// Programs that already hold the tables can use Tables::Writer directly instead.
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "numeric/Tables.hpp"
+
+static int usage(const char* program) {
+    std::fprintf(stderr, "usage: %s write OUT [--type=float|double] (--polynomial=NAME:FILE | --nodes=NAME:FILE)...\n"
+                         "       %s list FILE\n", program, program);
+    return 2;
+}
+
+static std::vector<double> read_numbers(const std::string& path) {
+    std::FILE* in = std::fopen(path.c_str(), "r");
+    if(in == nullptr)
+        throw std::system_error(errno, std::generic_category(), "Attempted to open " + path);
+
+    std::vector<double> res;
+    double x;
+    int read;
+    while((read = std::fscanf(in, "%lf", &x)) == 1)
+        res.push_back(x);
+    const bool complete = read == EOF && !std::ferror(in);
+    std::fclose(in);
+
+    if(!complete)
+        throw std::runtime_error("Attempted to read " + path + ", which holds something other than numbers");
+    return res;
+}
+
+template <class T>
+static void add_table(Tables::Writer& writer, bool nodes, const std::string& name, const std::string& path) {
+    const auto numbers = read_numbers(path);
+    if(!nodes) {
+        // The writer drops trailing zero coefficients, so the table holds the polynomial's true degree
+        const std::vector<T> coefficients(numbers.begin(), numbers.end());
+        writer.AddPolynomial(name, PolynomialView<T>(coefficients));
+        return;
+    }
+
+    if(numbers.size() % 2 != 0 || numbers.size() < 4)
+        throw std::runtime_error("Attempted to read nodes from " + path + ", which does not hold at least two x y pairs");
+
+    std::vector<std::pair<T, T>> points(numbers.size() / 2);
+    for(size_t i = 0; i < points.size(); i++)
+        points[i] = { T(numbers[2 * i]), T(numbers[2 * i + 1]) };
+    writer.AddBarycentric(name, points);
+}
+
+static int write(int argc, char** argv) {
+    std::string type = "double";
+    Tables::Writer writer;
+
+    for(int i = 3; i < argc; i++) {
+        if(std::strncmp(argv[i], "--type=", 7) == 0) {
+            type = argv[i] + 7;
+            if(type != "float" && type != "double")
+                return usage(argv[0]);
+            continue;
+        }
+
+        const bool polynomial = std::strncmp(argv[i], "--polynomial=", 13) == 0, nodes = std::strncmp(argv[i], "--nodes=", 8) == 0;
+        if(!polynomial && !nodes)
+            return usage(argv[0]);
+
+        const std::string spec = argv[i] + (polynomial ? 13 : 8);
+        const size_t colon = spec.find(':');
+        if(colon == std::string::npos)
+            return usage(argv[0]);
+
+        if(type == "float")
+            add_table<float>(writer, nodes, spec.substr(0, colon), spec.substr(colon + 1));
+        else
+            add_table<double>(writer, nodes, spec.substr(0, colon), spec.substr(colon + 1));
+    }
+
+    writer.Write(argv[2]);
+    std::printf("wrote %zu table(s) to %s\n", writer.Size(), argv[2]);
+    return 0;
+}
+
+static int list(const char* path) {
+    const Tables::Reader reader{ std::string(path) };
+
+    for(size_t i = 0; i < reader.Size(); i++) {
+        const auto e = reader.Entry(i);
+        std::printf("%-40.*s %-12s %-12.*s %8zu\n", int(e.Name.size()), e.Name.data(),
+                    e.Kind == Tables::TableKind::Polynomial ? "polynomial" : "barycentric", int(e.Scalar.size()), e.Scalar.data(), e.Length);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    try {
+        if(argc >= 3 && std::strcmp(argv[1], "write") == 0)
+            return write(argc, argv);
+        if(argc == 3 && std::strcmp(argv[1], "list") == 0)
+            return list(argv[2]);
+        return usage(argv[0]);
+    }
+    catch(const std::exception& e) {
+        std::fprintf(stderr, "%s: %s\n", argv[0], e.what());
+        return 1;
+    }
+}